@@ -810,6 +810,8 @@ int __init arch_early_irq_init(void)
 	vector_matrix = irq_alloc_matrix(NR_VECTORS, FIRST_EXTERNAL_VECTOR,
 					 FIRST_SYSTEM_VECTOR);
 	BUG_ON(!vector_matrix);
+	/* Steer new vectors away from CPUs busy with interrupts */
+	irq_matrix_set_cost(vector_matrix, irq_matrix_irq_rate);
 
 	return arch_early_ioapic_init();
 }
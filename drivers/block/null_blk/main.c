@@ -9,6 +9,7 @@
 #include <linux/sched.h>
 #include <linux/fs.h>
 #include <linux/init.h>
+#include <linux/random.h>
 #include "null_blk.h"
 
 #undef pr_fmt
@@ -205,6 +206,10 @@ static unsigned long g_completion_nsec = 10000;
 module_param_named(completion_nsec, g_completion_nsec, ulong, 0444);
 MODULE_PARM_DESC(completion_nsec, "Time in ns to complete a request in hardware. Default: 10,000ns");
 
+static unsigned long g_completion_nsec_jitter;
+module_param_named(completion_nsec_jitter, g_completion_nsec_jitter, ulong, 0444);
+MODULE_PARM_DESC(completion_nsec_jitter, "Upper bound in ns of a uniformly distributed delay added to completion_nsec. Default: 0");
+
 static int g_hw_queue_depth = 64;
 module_param_named(hw_queue_depth, g_hw_queue_depth, int, 0444);
 MODULE_PARM_DESC(hw_queue_depth, "Queue depth for each hardware queue. Default: 64");
@@ -440,6 +445,7 @@ static int nullb_apply_poll_queues(struct nullb_device *dev,
 
 NULLB_DEVICE_ATTR(size, ulong, NULL);
 NULLB_DEVICE_ATTR(completion_nsec, ulong, NULL);
+NULLB_DEVICE_ATTR(completion_nsec_jitter, ulong, NULL);
 NULLB_DEVICE_ATTR(submit_queues, uint, nullb_apply_submit_queues);
 NULLB_DEVICE_ATTR(poll_queues, uint, nullb_apply_poll_queues);
 NULLB_DEVICE_ATTR(home_node, uint, NULL);
@@ -589,6 +595,7 @@ CONFIGFS_ATTR_WO(nullb_device_, zone_offline);
 static struct configfs_attribute *nullb_device_attrs[] = {
 	&nullb_device_attr_size,
 	&nullb_device_attr_completion_nsec,
+	&nullb_device_attr_completion_nsec_jitter,
 	&nullb_device_attr_submit_queues,
 	&nullb_device_attr_poll_queues,
 	&nullb_device_attr_home_node,
@@ -700,7 +707,7 @@ static ssize_t memb_group_features_show(struct config_item *item, char *page)
 {
 	return snprintf(page, PAGE_SIZE,
 			"badblocks,blocking,blocksize,cache_size,fua,"
-			"completion_nsec,discard,home_node,hw_queue_depth,"
+			"completion_nsec,completion_nsec_jitter,discard,home_node,hw_queue_depth,"
 			"irqmode,max_sectors,mbps,memory_backed,no_sched,"
 			"poll_queues,power,queue_mode,shared_tag_bitmap,"
 			"shared_tags,size,submit_queues,use_per_node_hctx,"
@@ -764,6 +771,7 @@ static struct nullb_device *null_alloc_dev(void)
 
 	dev->size = g_gb * 1024;
 	dev->completion_nsec = g_completion_nsec;
+	dev->completion_nsec_jitter = g_completion_nsec_jitter;
 	dev->submit_queues = g_submit_queues;
 	dev->prev_submit_queues = g_submit_queues;
 	dev->poll_queues = g_poll_queues;
@@ -817,8 +825,12 @@ static enum hrtimer_restart null_cmd_timer_expired(struct hrtimer *timer)
 
 static void null_cmd_end_timer(struct nullb_cmd *cmd)
 {
-	ktime_t kt = cmd->nq->dev->completion_nsec;
+	struct nullb_device *dev = cmd->nq->dev;
+	ktime_t kt = dev->completion_nsec;
 
+	if (dev->completion_nsec_jitter)
+		kt += get_random_u32_below(min_t(unsigned long,
+				dev->completion_nsec_jitter, U32_MAX - 1) + 1);
 	hrtimer_start(&cmd->timer, kt, HRTIMER_MODE_REL);
 }
 
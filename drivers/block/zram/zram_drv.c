@@ -734,20 +734,231 @@ static int scan_slots_for_writeback(struct zram *zram, u32 mode,
 	return 0;
 }
 
+/*
+ * Number of pages writeback_store() keeps in flight.  Blocks are allocated
+ * from the bitmap in order, so a batch usually covers a contiguous range of
+ * the backing device and merges into a few large requests under the plug.
+ */
+#define ZRAM_WB_BATCH	32
+
+struct zram_wb_req {
+	struct zram_pp_slot	*pps;
+	unsigned long		blk_idx;
+	struct page		*page;
+	struct bio_vec		bio_vec;
+	struct bio		bio;
+};
+
+struct zram_wb_ctl {
+	atomic_t		num_inflight;
+	struct completion	done;
+	struct zram_wb_req	reqs[ZRAM_WB_BATCH];
+};
+
+static void release_wb_ctl(struct zram_wb_ctl *wb_ctl)
+{
+	int i;
+
+	if (!wb_ctl)
+		return;
+
+	for (i = 0; i < ZRAM_WB_BATCH; i++) {
+		if (wb_ctl->reqs[i].page)
+			__free_page(wb_ctl->reqs[i].page);
+	}
+	kfree(wb_ctl);
+}
+
+static struct zram_wb_ctl *init_wb_ctl(void)
+{
+	struct zram_wb_ctl *wb_ctl;
+	int i;
+
+	wb_ctl = kzalloc(sizeof(*wb_ctl), GFP_KERNEL);
+	if (!wb_ctl)
+		return NULL;
+
+	for (i = 0; i < ZRAM_WB_BATCH; i++) {
+		wb_ctl->reqs[i].page = alloc_page(GFP_KERNEL);
+		if (!wb_ctl->reqs[i].page) {
+			release_wb_ctl(wb_ctl);
+			return NULL;
+		}
+	}
+	init_completion(&wb_ctl->done);
+	return wb_ctl;
+}
+
+static void zram_writeback_endio(struct bio *bio)
+{
+	struct zram_wb_ctl *wb_ctl = bio->bi_private;
+
+	if (atomic_dec_and_test(&wb_ctl->num_inflight))
+		complete(&wb_ctl->done);
+}
+
+/* Charge one page against writeback_limit, if it is enabled. */
+static bool zram_wb_limit_get(struct zram *zram)
+{
+	bool ok = true;
+
+	spin_lock(&zram->wb_limit_lock);
+	if (zram->wb_limit_enable) {
+		if (!zram->bd_wb_limit)
+			ok = false;
+		else
+			zram->bd_wb_limit -= 1UL << (PAGE_SHIFT - 12);
+	}
+	spin_unlock(&zram->wb_limit_lock);
+
+	return ok;
+}
+
+static void zram_wb_limit_put(struct zram *zram)
+{
+	spin_lock(&zram->wb_limit_lock);
+	if (zram->wb_limit_enable)
+		zram->bd_wb_limit += 1UL << (PAGE_SHIFT - 12);
+	spin_unlock(&zram->wb_limit_lock);
+}
+
+/*
+ * Fill @wb_ctl with up to ZRAM_WB_BATCH slots read from @ctl.  Returns the
+ * number of requests prepared; *ret is set when writeback must stop.
+ */
+static int zram_writeback_prepare(struct zram *zram, struct zram_pp_ctl *ctl,
+				  struct zram_wb_ctl *wb_ctl, ssize_t *ret,
+				  bool *stop)
+{
+	struct zram_pp_slot *pps;
+	int nr = 0;
+
+	while (nr < ZRAM_WB_BATCH && (pps = select_pp_slot(ctl))) {
+		struct zram_wb_req *req = &wb_ctl->reqs[nr];
+		u32 index = pps->index;
+
+		/* The slot is owned by this batch from now on */
+		list_del_init(&pps->entry);
+
+		zram_slot_lock(zram, index);
+		/*
+		 * scan_slots() sets ZRAM_PP_SLOT and relases slot lock, so
+		 * slots can change in the meantime. If slots are accessed or
+		 * freed they lose ZRAM_PP_SLOT flag and hence we don't
+		 * post-process them.
+		 */
+		if (!zram_test_flag(zram, index, ZRAM_PP_SLOT)) {
+			zram_slot_unlock(zram, index);
+			release_pp_slot(zram, pps);
+			continue;
+		}
+		zram_slot_unlock(zram, index);
+
+		if (zram_read_page(zram, req->page, index, NULL)) {
+			release_pp_slot(zram, pps);
+			continue;
+		}
+
+		if (!zram_wb_limit_get(zram)) {
+			release_pp_slot(zram, pps);
+			*ret = -EIO;
+			*stop = true;
+			break;
+		}
+
+		req->blk_idx = alloc_block_bdev(zram);
+		if (!req->blk_idx) {
+			zram_wb_limit_put(zram);
+			release_pp_slot(zram, pps);
+			*ret = -ENOSPC;
+			*stop = true;
+			break;
+		}
+
+		req->pps = pps;
+		nr++;
+	}
+
+	return nr;
+}
+
+static void zram_writeback_submit(struct zram *zram,
+				  struct zram_wb_ctl *wb_ctl, int nr)
+{
+	struct blk_plug plug;
+	int i;
+
+	atomic_set(&wb_ctl->num_inflight, nr);
+	reinit_completion(&wb_ctl->done);
+
+	blk_start_plug(&plug);
+	for (i = 0; i < nr; i++) {
+		struct zram_wb_req *req = &wb_ctl->reqs[i];
+
+		bio_init(&req->bio, zram->bdev, &req->bio_vec, 1,
+			 REQ_OP_WRITE | REQ_SYNC);
+		req->bio.bi_iter.bi_sector = req->blk_idx * (PAGE_SIZE >> 9);
+		req->bio.bi_end_io = zram_writeback_endio;
+		req->bio.bi_private = wb_ctl;
+		__bio_add_page(&req->bio, req->page, PAGE_SIZE, 0);
+		submit_bio(&req->bio);
+	}
+	blk_finish_plug(&plug);
+
+	wait_for_completion_io(&wb_ctl->done);
+}
+
+static int zram_writeback_complete(struct zram *zram, struct zram_wb_req *req)
+{
+	u32 index = req->pps->index;
+	int err;
+
+	err = blk_status_to_errno(req->bio.bi_status);
+	bio_uninit(&req->bio);
+	if (err)
+		goto fail;
+
+	atomic64_inc(&zram->stats.bd_writes);
+	zram_slot_lock(zram, index);
+	/*
+	 * Same as above, we release slot lock during writeback so
+	 * slot can change under us: slot_free() or slot_free() and
+	 * reallocation (zram_write_page()). In both cases slot loses
+	 * ZRAM_PP_SLOT flag. No concurrent post-processing can set
+	 * ZRAM_PP_SLOT on such slots until current post-processing
+	 * finishes.
+	 */
+	if (!zram_test_flag(zram, index, ZRAM_PP_SLOT)) {
+		zram_slot_unlock(zram, index);
+		goto fail;
+	}
+
+	zram_free_page(zram, index);
+	zram_set_flag(zram, index, ZRAM_WB);
+	zram_set_element(zram, index, req->blk_idx);
+	atomic64_inc(&zram->stats.pages_stored);
+	zram_slot_unlock(zram, index);
+	release_pp_slot(zram, req->pps);
+	return 0;
+
+fail:
+	free_block_bdev(zram, req->blk_idx);
+	zram_wb_limit_put(zram);
+	release_pp_slot(zram, req->pps);
+	return err;
+}
+
 static ssize_t writeback_store(struct device *dev,
 		struct device_attribute *attr, const char *buf, size_t len)
 {
 	struct zram *zram = dev_to_zram(dev);
 	unsigned long nr_pages = zram->disksize >> PAGE_SHIFT;
+	struct zram_wb_ctl *wb_ctl = NULL;
 	struct zram_pp_ctl *ctl = NULL;
-	struct zram_pp_slot *pps;
 	unsigned long index = 0;
-	struct bio bio;
-	struct bio_vec bio_vec;
-	struct page *page;
 	ssize_t ret = len;
-	int mode, err;
-	unsigned long blk_idx = 0;
+	bool stop = false;
+	int mode, err, nr, i;
 
 	if (sysfs_streq(buf, "idle"))
 		mode = IDLE_WRITEBACK;
@@ -786,8 +997,8 @@ static ssize_t writeback_store(struct device *dev,
 		goto release_init_lock;
 	}
 
-	page = alloc_page(GFP_KERNEL);
-	if (!page) {
+	wb_ctl = init_wb_ctl();
+	if (!wb_ctl) {
 		ret = -ENOMEM;
 		goto release_init_lock;
 	}
@@ -800,52 +1011,15 @@ static ssize_t writeback_store(struct device *dev,
 
 	scan_slots_for_writeback(zram, mode, nr_pages, index, ctl);
 
-	while ((pps = select_pp_slot(ctl))) {
-		spin_lock(&zram->wb_limit_lock);
-		if (zram->wb_limit_enable && !zram->bd_wb_limit) {
-			spin_unlock(&zram->wb_limit_lock);
-			ret = -EIO;
+	while (!stop) {
+		nr = zram_writeback_prepare(zram, ctl, wb_ctl, &ret, &stop);
+		if (!nr)
 			break;
-		}
-		spin_unlock(&zram->wb_limit_lock);
 
-		if (!blk_idx) {
-			blk_idx = alloc_block_bdev(zram);
-			if (!blk_idx) {
-				ret = -ENOSPC;
-				break;
-			}
-		}
-
-		index = pps->index;
-		zram_slot_lock(zram, index);
-		/*
-		 * scan_slots() sets ZRAM_PP_SLOT and relases slot lock, so
-		 * slots can change in the meantime. If slots are accessed or
-		 * freed they lose ZRAM_PP_SLOT flag and hence we don't
-		 * post-process them.
-		 */
-		if (!zram_test_flag(zram, index, ZRAM_PP_SLOT))
-			goto next;
-		zram_slot_unlock(zram, index);
-
-		if (zram_read_page(zram, page, index, NULL)) {
-			release_pp_slot(zram, pps);
-			continue;
-		}
-
-		bio_init(&bio, zram->bdev, &bio_vec, 1,
-			 REQ_OP_WRITE | REQ_SYNC);
-		bio.bi_iter.bi_sector = blk_idx * (PAGE_SIZE >> 9);
-		__bio_add_page(&bio, page, PAGE_SIZE, 0);
+		zram_writeback_submit(zram, wb_ctl, nr);
 
-		/*
-		 * XXX: A single page IO would be inefficient for write
-		 * but it would be not bad as starter.
-		 */
-		err = submit_bio_wait(&bio);
-		if (err) {
-			release_pp_slot(zram, pps);
+		for (i = 0; i < nr; i++) {
+			err = zram_writeback_complete(zram, &wb_ctl->reqs[i]);
 			/*
 			 * BIO errors are not fatal, we continue and simply
 			 * attempt to writeback the remaining objects (pages).
@@ -854,41 +1028,13 @@ static ssize_t writeback_store(struct device *dev,
 			 * them) were not successful and we do so by returning
 			 * the most recent BIO error.
 			 */
-			ret = err;
-			continue;
+			if (err)
+				ret = err;
 		}
-
-		atomic64_inc(&zram->stats.bd_writes);
-		zram_slot_lock(zram, index);
-		/*
-		 * Same as above, we release slot lock during writeback so
-		 * slot can change under us: slot_free() or slot_free() and
-		 * reallocation (zram_write_page()). In both cases slot loses
-		 * ZRAM_PP_SLOT flag. No concurrent post-processing can set
-		 * ZRAM_PP_SLOT on such slots until current post-processing
-		 * finishes.
-		 */
-		if (!zram_test_flag(zram, index, ZRAM_PP_SLOT))
-			goto next;
-
-		zram_free_page(zram, index);
-		zram_set_flag(zram, index, ZRAM_WB);
-		zram_set_element(zram, index, blk_idx);
-		blk_idx = 0;
-		atomic64_inc(&zram->stats.pages_stored);
-		spin_lock(&zram->wb_limit_lock);
-		if (zram->wb_limit_enable && zram->bd_wb_limit > 0)
-			zram->bd_wb_limit -=  1UL << (PAGE_SHIFT - 12);
-		spin_unlock(&zram->wb_limit_lock);
-next:
-		zram_slot_unlock(zram, index);
-		release_pp_slot(zram, pps);
 	}
 
-	if (blk_idx)
-		free_block_bdev(zram, blk_idx);
-	__free_page(page);
 release_init_lock:
+	release_wb_ctl(wb_ctl);
 	release_pp_ctl(zram, ctl);
 	atomic_set(&zram->pp_in_progress, 0);
 	up_read(&zram->init_lock);
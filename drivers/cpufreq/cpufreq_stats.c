@@ -275,6 +275,14 @@ void cpufreq_stats_record_transition(struct cpufreq_policy *policy,
 		cpufreq_stats_reset_table(stats);
 
 	old_index = stats->last_index;
+
+	/*
+	 * Fast switching drivers report every request, most of which don't
+	 * change the frequency. Catch those before scanning the table.
+	 */
+	if (old_index != -1 && stats->freq_table[old_index] == new_freq)
+		return;
+
 	new_index = freq_table_get_index(stats, new_freq);
 
 	/* We can't do stats->time_in_state[-1]= .. */
@@ -595,6 +595,9 @@ static int dmatest_func(void *data)
 	ktime_t			ktime, start, diff;
 	ktime_t			filltime = 0;
 	ktime_t			comparetime = 0;
+	ktime_t			submit, lat;
+	s64			lat_min = S64_MAX, lat_max = 0, lat_total = 0;
+	unsigned int		lat_cnt = 0;
 	s64			runtime = 0;
 	unsigned long long	total_len = 0;
 	unsigned long long	iops = 0;
@@ -824,6 +827,7 @@ static int dmatest_func(void *data)
 			tx->callback = dmatest_callback;
 			tx->callback_param = done;
 		}
+		submit = ktime_get();
 		cookie = tx->tx_submit(tx);
 
 		if (dma_submit_error(cookie)) {
@@ -848,6 +852,7 @@ static int dmatest_func(void *data)
 			status = dma_async_is_tx_complete(chan, cookie, NULL,
 							  NULL);
 		}
+		lat = ktime_sub(ktime_get(), submit);
 
 		if (!done->done) {
 			result("test timed out", total_tests, src->off, dst->off,
@@ -864,6 +869,11 @@ static int dmatest_func(void *data)
 			goto error_unmap_continue;
 		}
 
+		lat_min = min_t(s64, lat_min, ktime_to_ns(lat));
+		lat_max = max_t(s64, lat_max, ktime_to_ns(lat));
+		lat_total += ktime_to_ns(lat);
+		lat_cnt++;
+
 		dmaengine_unmap_put(um);
 
 		if (params->noverify) {
@@ -934,6 +944,10 @@ static int dmatest_func(void *data)
 		current->comm, total_tests, failed_tests,
 		FIXPT_TO_INT(iops), FIXPT_GET_FRAC(iops),
 		dmatest_KBs(runtime, total_len), ret);
+	if (lat_cnt)
+		pr_info("%s: latency min %lld avg %lld max %lld ns (%s)\n",
+			current->comm, lat_min, div_s64(lat_total, lat_cnt),
+			lat_max, params->polled ? "polled" : "interrupt");
 
 	/* terminate all transfers on specified channels */
 	if (ret || failed_tests)
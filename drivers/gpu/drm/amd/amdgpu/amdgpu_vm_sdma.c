@@ -38,9 +38,9 @@ static int amdgpu_vm_sdma_map_table(struct amdgpu_bo_vm *table)
 	return amdgpu_ttm_alloc_gart(&table->bo.tbo);
 }
 
-/* Allocate a new job for @count PTE updates */
+/* Allocate a new job for @count PTE updates and at least @min_ndw dw */
 static int amdgpu_vm_sdma_alloc_job(struct amdgpu_vm_update_params *p,
-				    unsigned int count)
+				    unsigned int count, unsigned int min_ndw)
 {
 	enum amdgpu_ib_pool_type pool = p->immediate ? AMDGPU_IB_POOL_IMMEDIATE
 		: AMDGPU_IB_POOL_DELAYED;
@@ -50,7 +50,7 @@ static int amdgpu_vm_sdma_alloc_job(struct amdgpu_vm_update_params *p,
 	int r;
 
 	/* estimate how many dw we need */
-	ndw = AMDGPU_VM_SDMA_MIN_NUM_DW;
+	ndw = max(AMDGPU_VM_SDMA_MIN_NUM_DW, min_ndw);
 	if (p->pages_addr)
 		ndw += count * 2;
 	ndw = min(ndw, AMDGPU_VM_SDMA_MAX_NUM_DW);
@@ -78,7 +78,7 @@ static int amdgpu_vm_sdma_prepare(struct amdgpu_vm_update_params *p,
 {
 	int r;
 
-	r = amdgpu_vm_sdma_alloc_job(p, 0);
+	r = amdgpu_vm_sdma_alloc_job(p, 0, 0);
 	if (r)
 		return r;
 
@@ -245,11 +245,17 @@ static int amdgpu_vm_sdma_update(struct amdgpu_vm_update_params *p,
 		ndw -= p->job->ibs->length_dw;
 
 		if (ndw < 32) {
+			/*
+			 * This batch of updates outgrew the IB, so use a bigger
+			 * one for the rest to avoid submitting lots of small jobs.
+			 */
+			unsigned int prev_ndw = p->num_dw_left;
+
 			r = amdgpu_vm_sdma_commit(p, NULL);
 			if (r)
 				return r;
 
-			r = amdgpu_vm_sdma_alloc_job(p, count);
+			r = amdgpu_vm_sdma_alloc_job(p, count, prev_ndw * 2);
 			if (r)
 				return r;
 		}
@@ -50,11 +50,16 @@ static void list_insert_sorted(struct drm_buddy *mm,
 		return;
 	}
 
-	list_for_each_entry(node, head, link)
-		if (drm_buddy_block_offset(block) < drm_buddy_block_offset(node))
+	/*
+	 * Allocation always consumes from the tail (highest offset) of the
+	 * free list, so churn is concentrated there. Walk backwards so that
+	 * the common case of re-inserting a high block is cheap.
+	 */
+	list_for_each_entry_reverse(node, head, link)
+		if (drm_buddy_block_offset(block) > drm_buddy_block_offset(node))
 			break;
 
-	__list_add(&block->link, node->link.prev, &node->link);
+	__list_add(&block->link, &node->link, node->link.next);
 }
 
 static void clear_reset(struct drm_buddy_block *block)
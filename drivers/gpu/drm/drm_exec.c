@@ -142,15 +142,17 @@ static int drm_exec_obj_locked(struct drm_exec *exec,
 			       struct drm_gem_object *obj)
 {
 	if (unlikely(exec->num_objects == exec->max_objects)) {
-		size_t size = exec->max_objects * sizeof(void *);
+		/* Grow geometrically to avoid repeated copies on big submits */
+		unsigned int nr = max_t(unsigned int, exec->max_objects * 2,
+					PAGE_SIZE / sizeof(void *));
 		void *tmp;
 
-		tmp = kvrealloc(exec->objects, size + PAGE_SIZE, GFP_KERNEL);
+		tmp = kvrealloc(exec->objects, nr * sizeof(void *), GFP_KERNEL);
 		if (!tmp)
 			return -ENOMEM;
 
 		exec->objects = tmp;
-		exec->max_objects += PAGE_SIZE / sizeof(void *);
+		exec->max_objects = nr;
 	}
 	drm_gem_object_get(obj);
 	exec->objects[exec->num_objects++] = obj;
@@ -551,6 +551,14 @@ int drm_mm_insert_node_in_range(struct drm_mm * const mm,
 		if (mode == DRM_MM_INSERT_HIGH && hole_end <= range_start)
 			break;
 
+		/*
+		 * color_adjust() may only shrink the hole, so a hole lying
+		 * outside the range can be rejected without calling it.
+		 */
+		if (hole_end <= range_start || hole_start >= range_end ||
+		    min(hole_end, range_end) - max(hole_start, range_start) < size)
+			continue;
+
 		col_start = hole_start;
 		col_end = hole_end;
 		if (mm->color_adjust)
@@ -200,6 +200,34 @@ static struct xe_vm *asid_to_vm(struct xe_device *xe, u32 asid)
 	return vm;
 }
 
+/*
+ * Fault storms typically hit neighbouring pages of a VMA which the first
+ * fault has already rebound. Check for that under the read lock so that
+ * parallel fault workers don't serialize on vm->lock just to find out there
+ * is nothing to do.
+ */
+static bool pagefault_already_resolved(struct xe_tile *tile, struct xe_vm *vm,
+				       struct pagefault *pf)
+{
+	struct xe_vma *vma;
+	bool resolved = false;
+
+	if (access_is_atomic(pf->access_type))
+		return false;
+
+	down_read(&vm->lock);
+	if (!xe_vm_is_closed(vm)) {
+		vma = lookup_vma(vm, pf->page_addr);
+		if (vma && vma_is_valid(tile, vma)) {
+			trace_xe_vma_pagefault(vma);
+			resolved = true;
+		}
+	}
+	up_read(&vm->lock);
+
+	return resolved;
+}
+
 static int handle_pagefault(struct xe_gt *gt, struct pagefault *pf)
 {
 	struct xe_device *xe = gt_to_xe(gt);
@@ -216,6 +244,11 @@ static int handle_pagefault(struct xe_gt *gt, struct pagefault *pf)
 	if (IS_ERR(vm))
 		return PTR_ERR(vm);
 
+	if (pagefault_already_resolved(tile, vm, pf)) {
+		xe_vm_put(vm);
+		return 0;
+	}
+
 	/*
 	 * TODO: Change to read lock? Using write lock for simplicity.
 	 */
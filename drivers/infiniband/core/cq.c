@@ -465,8 +465,11 @@ struct ib_cq *ib_cq_pool_get(struct ib_device *dev, unsigned int nr_cqe,
 				continue;
 			if (cq->cqe_used + nr_cqe > cq->cqe)
 				continue;
+			if (found && found->cqe_used <= cq->cqe_used)
+				continue;
 			found = cq;
-			break;
+			if (!found->cqe_used)
+				break;
 		}
 
 		if (found) {
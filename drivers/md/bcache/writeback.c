@@ -479,6 +479,7 @@ static void read_dirty(struct cached_dev *dc)
 	int nk, i;
 	struct dirty_io *io;
 	struct closure cl;
+	struct blk_plug plug;
 	uint16_t sequence = 0;
 
 	BUG_ON(!llist_empty(&dc->writeback_ordering_wait.list));
@@ -532,7 +533,13 @@ static void read_dirty(struct cached_dev *dc)
 			keys[nk++] = next;
 		} while ((next = bch_keybuf_next(&dc->writeback_keys)));
 
-		/* Now we have gathered a set of 1..5 keys to write back. */
+		/*
+		 * Now we have gathered a set of 1..5 keys to write back.
+		 * Keys that are contiguous on the backing device were usually
+		 * written together and so tend to sit next to each other in
+		 * the cache as well; plug so their reads can be merged.
+		 */
+		blk_start_plug(&plug);
 		for (i = 0; i < nk; i++) {
 			w = keys[i];
 
@@ -566,6 +573,7 @@ static void read_dirty(struct cached_dev *dc)
 			 */
 			closure_call(&io->cl, read_dirty_submit, NULL, &cl);
 		}
+		blk_finish_plug(&plug);
 
 		delay = writeback_delay(dc, size);
 
@@ -581,6 +589,7 @@ static void read_dirty(struct cached_dev *dc)
 err_free:
 		kfree(w->private);
 err:
+		blk_finish_plug(&plug);
 		bch_keybuf_del(&dc->writeback_keys, w);
 	}
 
@@ -5195,6 +5195,15 @@ static void bond_reset_slave_arr(struct bonding *bond)
 	bond_set_slave_arr(bond, NULL, NULL);
 }
 
+static bool bond_slave_arr_equal(const struct bond_up_slave *a,
+				 const struct bond_up_slave *b)
+{
+	if (!a || !b || a->count != b->count)
+		return false;
+
+	return !memcmp(a->arr, b->arr, a->count * sizeof(a->arr[0]));
+}
+
 /* Build the usable slaves array in control path for modes that use xmit-hash
  * to determine the slave interface -
  * (a) BOND_MODE_8023AD
@@ -5258,6 +5267,20 @@ int bond_update_slave_arr(struct bonding *bond, struct slave *skipslave)
 		usable_slaves->arr[usable_slaves->count++] = slave;
 	}
 
+	/* LACP and link monitor events often trigger a rebuild that
+	 * ends up with exactly the arrays already in use.  Don't
+	 * republish those: it only costs two RCU frees and makes the
+	 * transmit path refetch the array.
+	 */
+	if (bond_slave_arr_equal(usable_slaves,
+				 rtnl_dereference(bond->usable_slaves)) &&
+	    bond_slave_arr_equal(all_slaves,
+				 rtnl_dereference(bond->all_slaves))) {
+		kfree(usable_slaves);
+		kfree(all_slaves);
+		return ret;
+	}
+
 	bond_set_slave_arr(bond, usable_slaves, all_slaves);
 	return ret;
 out:
@@ -30,7 +30,8 @@
 #define IPVLAN_DRV	"ipvlan"
 #define IPV_DRV_VER	"0.1"
 
-#define IPVLAN_HASH_SIZE	(1 << BITS_PER_BYTE)
+#define IPVLAN_HASH_BITS	10
+#define IPVLAN_HASH_SIZE	(1 << IPVLAN_HASH_BITS)
 #define IPVLAN_HASH_MASK	(IPVLAN_HASH_SIZE - 1)
 
 #define IPVLAN_MAC_FILTER_BITS	8
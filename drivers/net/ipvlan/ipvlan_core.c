@@ -34,7 +34,7 @@ void ipvlan_count_rx(const struct ipvl_dev *ipvlan,
 EXPORT_SYMBOL_GPL(ipvlan_count_rx);
 
 #if IS_ENABLED(CONFIG_IPV6)
-static u8 ipvlan_get_v6_hash(const void *iaddr)
+static u32 ipvlan_get_v6_hash(const void *iaddr)
 {
 	const struct in6_addr *ip6_addr = iaddr;
 
@@ -42,13 +42,13 @@ static u8 ipvlan_get_v6_hash(const void *iaddr)
 	       IPVLAN_HASH_MASK;
 }
 #else
-static u8 ipvlan_get_v6_hash(const void *iaddr)
+static u32 ipvlan_get_v6_hash(const void *iaddr)
 {
 	return 0;
 }
 #endif
 
-static u8 ipvlan_get_v4_hash(const void *iaddr)
+static u32 ipvlan_get_v4_hash(const void *iaddr)
 {
 	const struct in_addr *ip4_addr = iaddr;
 
@@ -77,7 +77,7 @@ static struct ipvl_addr *ipvlan_ht_addr_lookup(const struct ipvl_port *port,
 					       const void *iaddr, bool is_v6)
 {
 	struct ipvl_addr *addr;
-	u8 hash;
+	u32 hash;
 
 	hash = is_v6 ? ipvlan_get_v6_hash(iaddr) :
 	       ipvlan_get_v4_hash(iaddr);
@@ -90,7 +90,7 @@ static struct ipvl_addr *ipvlan_ht_addr_lookup(const struct ipvl_port *port,
 void ipvlan_ht_addr_add(struct ipvl_dev *ipvlan, struct ipvl_addr *addr)
 {
 	struct ipvl_port *port = ipvlan->port;
-	u8 hash;
+	u32 hash;
 
 	hash = (addr->atype == IPVL_IPV6) ?
 	       ipvlan_get_v6_hash(&addr->ip6addr) :
@@ -63,7 +63,7 @@ static int ipvlan_port_create(struct net_device *dev)
 	struct ipvl_port *port;
 	int err, idx;
 
-	port = kzalloc(sizeof(struct ipvl_port), GFP_KERNEL);
+	port = kvzalloc(sizeof(struct ipvl_port), GFP_KERNEL);
 	if (!port)
 		return -ENOMEM;
 
@@ -87,7 +87,7 @@ static int ipvlan_port_create(struct net_device *dev)
 	return 0;
 
 err:
-	kfree(port);
+	kvfree(port);
 	return err;
 }
 
@@ -106,7 +106,7 @@ static void ipvlan_port_destroy(struct net_device *dev)
 		kfree_skb(skb);
 	}
 	ida_destroy(&port->ida);
-	kfree(port);
+	kvfree(port);
 }
 
 #define IPVLAN_ALWAYS_ON_OFLOADS \
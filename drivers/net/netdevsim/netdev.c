@@ -58,9 +58,6 @@ static netdev_tx_t nsim_start_xmit(struct sk_buff *skb, struct net_device *dev)
 	int rxq;
 
 	rcu_read_lock();
-	if (!nsim_ipsec_tx(ns, skb))
-		goto out_drop_free;
-
 	peer_ns = rcu_dereference(ns->peer);
 	if (!peer_ns)
 		goto out_drop_free;
@@ -71,11 +68,20 @@ static netdev_tx_t nsim_start_xmit(struct sk_buff *skb, struct net_device *dev)
 		rxq = rxq % peer_dev->num_rx_queues;
 	rq = &peer_ns->rq[rxq];
 
+	if (!nsim_ipsec_tx(ns, skb)) {
+		dev_kfree_skb(skb);
+		goto out_drop_kick;
+	}
+
 	skb_tx_timestamp(skb);
 	if (unlikely(nsim_forward_skb(peer_dev, skb, rq) == NET_RX_DROP))
-		goto out_drop_cnt;
+		goto out_drop_kick;
 
-	napi_schedule(&rq->napi);
+	/* Like a real NIC, only ring the doorbell at the end of a batch,
+	 * so that xmit_more behaviour of the stack can be exercised.
+	 */
+	if (!netdev_xmit_more())
+		napi_schedule(&rq->napi);
 
 	rcu_read_unlock();
 	u64_stats_update_begin(&ns->syncp);
@@ -84,6 +90,13 @@ static netdev_tx_t nsim_start_xmit(struct sk_buff *skb, struct net_device *dev)
 	u64_stats_update_end(&ns->syncp);
 	return NETDEV_TX_OK;
 
+out_drop_kick:
+	/* Earlier packets of this batch may still be waiting for the
+	 * doorbell.
+	 */
+	if (!netdev_xmit_more())
+		napi_schedule(&rq->napi);
+	goto out_drop_cnt;
 out_drop_free:
 	dev_kfree_skb(skb);
 out_drop_cnt:
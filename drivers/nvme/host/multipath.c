@@ -18,6 +18,7 @@ static const char *nvme_iopolicy_names[] = {
 	[NVME_IOPOLICY_NUMA]	= "numa",
 	[NVME_IOPOLICY_RR]	= "round-robin",
 	[NVME_IOPOLICY_QD]      = "queue-depth",
+	[NVME_IOPOLICY_ADAPTIVE] = "adaptive",
 };
 
 static int iopolicy = NVME_IOPOLICY_NUMA;
@@ -32,6 +33,8 @@ static int nvme_set_iopolicy(const char *val, const struct kernel_param *kp)
 		iopolicy = NVME_IOPOLICY_RR;
 	else if (!strncmp(val, "queue-depth", 11))
 		iopolicy = NVME_IOPOLICY_QD;
+	else if (!strncmp(val, "adaptive", 8))
+		iopolicy = NVME_IOPOLICY_ADAPTIVE;
 	else
 		return -EINVAL;
 
@@ -46,7 +49,7 @@ static int nvme_get_iopolicy(char *buf, const struct kernel_param *kp)
 module_param_call(iopolicy, nvme_set_iopolicy, nvme_get_iopolicy,
 	&iopolicy, 0644);
 MODULE_PARM_DESC(iopolicy,
-	"Default multipath I/O policy; 'numa' (default), 'round-robin' or 'queue-depth'");
+	"Default multipath I/O policy; 'numa' (default), 'round-robin', 'queue-depth' or 'adaptive'");
 
 void nvme_mpath_default_iopolicy(struct nvme_subsystem *subsys)
 {
@@ -131,9 +134,17 @@ void nvme_mpath_start_request(struct request *rq)
 	struct nvme_ns *ns = rq->q->queuedata;
 	struct gendisk *disk = ns->head->disk;
 
-	if (READ_ONCE(ns->head->subsys->iopolicy) == NVME_IOPOLICY_QD) {
+	switch (READ_ONCE(ns->head->subsys->iopolicy)) {
+	case NVME_IOPOLICY_ADAPTIVE:
+		nvme_req(rq)->lat_start_ns = ktime_get_ns();
+		nvme_req(rq)->flags |= NVME_MPATH_TRACK_LAT;
+		fallthrough;
+	case NVME_IOPOLICY_QD:
 		atomic_inc(&ns->ctrl->nr_active);
 		nvme_req(rq)->flags |= NVME_MPATH_CNT_ACTIVE;
+		break;
+	default:
+		break;
 	}
 
 	if (!blk_queue_io_stat(disk->queue) || blk_rq_is_passthrough(rq))
@@ -145,12 +156,39 @@ void nvme_mpath_start_request(struct request *rq)
 }
 EXPORT_SYMBOL_GPL(nvme_mpath_start_request);
 
+/*
+ * Fold the service time of a completed request into the controller's
+ * moving average, weighting each new sample by 1/NVME_MPATH_LAT_WEIGHT.
+ * Updates race benignly between CPUs; losing the odd sample is fine.
+ */
+#define NVME_MPATH_LAT_WEIGHT	8
+
+static void nvme_mpath_update_latency(struct nvme_ctrl *ctrl, u64 start_ns)
+{
+	u64 now = ktime_get_ns(), lat, ewma;
+
+	if (unlikely(now < start_ns))
+		return;
+	lat = now - start_ns;
+
+	ewma = READ_ONCE(ctrl->lat_ewma_ns);
+	if (!ewma || time_after(jiffies, READ_ONCE(ctrl->lat_stamp) + HZ))
+		ewma = lat;
+	else
+		ewma += div_u64(lat, NVME_MPATH_LAT_WEIGHT) -
+			div_u64(ewma, NVME_MPATH_LAT_WEIGHT);
+	WRITE_ONCE(ctrl->lat_ewma_ns, ewma);
+	WRITE_ONCE(ctrl->lat_stamp, jiffies);
+}
+
 void nvme_mpath_end_request(struct request *rq)
 {
 	struct nvme_ns *ns = rq->q->queuedata;
 
 	if (nvme_req(rq)->flags & NVME_MPATH_CNT_ACTIVE)
 		atomic_dec_if_positive(&ns->ctrl->nr_active);
+	if (nvme_req(rq)->flags & NVME_MPATH_TRACK_LAT)
+		nvme_mpath_update_latency(ns->ctrl, nvme_req(rq)->lat_start_ns);
 
 	if (!(nvme_req(rq)->flags & NVME_MPATH_IO_STATS))
 		return;
@@ -391,6 +429,61 @@ static struct nvme_ns *nvme_queue_depth_path(struct nvme_ns_head *head)
 	return best_opt ? best_opt : best_nonopt;
 }
 
+/*
+ * Pick the path with the lowest expected wait, estimated as the number of
+ * outstanding commands times the recent per-command service time.  A path
+ * that has not completed anything for a second has a stale estimate.  If it
+ * has nothing outstanding it is scored as idle so that it gets probed again,
+ * otherwise its commands have been stuck for at least a second each and it
+ * is scored accordingly.
+ */
+static struct nvme_ns *nvme_adaptive_path(struct nvme_ns_head *head)
+{
+	struct nvme_ns *best_opt = NULL, *best_nonopt = NULL, *ns;
+	u64 min_cost_opt = U64_MAX, min_cost_nonopt = U64_MAX;
+	struct nvme_ctrl *ctrl;
+	int nr_active;
+	u64 cost;
+
+	list_for_each_entry_srcu(ns, &head->list, siblings,
+				 srcu_read_lock_held(&head->srcu)) {
+		if (nvme_path_is_disabled(ns))
+			continue;
+
+		ctrl = ns->ctrl;
+		nr_active = atomic_read(&ctrl->nr_active);
+		if (!time_after(jiffies, READ_ONCE(ctrl->lat_stamp) + HZ))
+			cost = (u64)(nr_active + 1) *
+				READ_ONCE(ctrl->lat_ewma_ns);
+		else if (nr_active)
+			cost = (u64)nr_active * NSEC_PER_SEC;
+		else
+			cost = 0;
+
+		switch (ns->ana_state) {
+		case NVME_ANA_OPTIMIZED:
+			if (cost < min_cost_opt) {
+				min_cost_opt = cost;
+				best_opt = ns;
+			}
+			break;
+		case NVME_ANA_NONOPTIMIZED:
+			if (cost < min_cost_nonopt) {
+				min_cost_nonopt = cost;
+				best_nonopt = ns;
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (min_cost_opt == 0)
+			return best_opt;
+	}
+
+	return best_opt ? best_opt : best_nonopt;
+}
+
 static inline bool nvme_path_is_optimized(struct nvme_ns *ns)
 {
 	return nvme_ctrl_state(ns->ctrl) == NVME_CTRL_LIVE &&
@@ -415,6 +508,8 @@ inline struct nvme_ns *nvme_find_path(struct nvme_ns_head *head)
 	switch (READ_ONCE(head->subsys->iopolicy)) {
 	case NVME_IOPOLICY_QD:
 		return nvme_queue_depth_path(head);
+	case NVME_IOPOLICY_ADAPTIVE:
+		return nvme_adaptive_path(head);
 	case NVME_IOPOLICY_RR:
 		return nvme_round_robin_path(head);
 	default:
@@ -1045,6 +1140,8 @@ int nvme_mpath_init_identify(struct nvme_ctrl *ctrl, struct nvme_id_ctrl *id)
 
 	/* initialize this in the identify path to cover controller resets */
 	atomic_set(&ctrl->nr_active, 0);
+	ctrl->lat_ewma_ns = 0;
+	ctrl->lat_stamp = jiffies - 2 * HZ;
 
 	if (!ctrl->max_namespaces ||
 	    ctrl->max_namespaces > le32_to_cpu(id->nn)) {
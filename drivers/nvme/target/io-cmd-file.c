@@ -195,6 +195,17 @@ static bool nvmet_file_execute_io(struct nvmet_req *req, int ki_flags)
 		if ((ki_flags & IOCB_NOWAIT))
 			return false;
 		break;
+	default:
+		/*
+		 * A buffered IOCB_NOWAIT attempt stops at the first page that
+		 * is not cached (or would block on writeback) and returns the
+		 * bytes it did transfer.  Rather than failing the command for
+		 * a short transfer, replay the whole range from the workqueue;
+		 * both directions are idempotent over the same range.
+		 */
+		if ((ki_flags & IOCB_NOWAIT) && ret >= 0 && ret < total_len)
+			return false;
+		break;
 	}
 
 complete:
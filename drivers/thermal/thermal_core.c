@@ -310,7 +310,11 @@ static void thermal_zone_broken_disable(struct thermal_zone_device *tz)
 static void thermal_zone_device_set_polling(struct thermal_zone_device *tz,
 					    unsigned long delay)
 {
-	if (delay > HZ)
+	/*
+	 * Let zones polling once a second or slower, which includes the very
+	 * common 1000 ms polling-delay, wake up together on whole seconds.
+	 */
+	if (delay >= HZ)
 		delay = round_jiffies_relative(delay);
 
 	mod_delayed_work(system_freezable_power_efficient_wq, &tz->poll_queue, delay);
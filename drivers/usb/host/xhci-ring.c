@@ -3030,7 +3030,6 @@ static void xhci_update_erst_dequeue(struct xhci_hcd *xhci,
 	u64 temp_64;
 	dma_addr_t deq;
 
-	temp_64 = xhci_read_64(xhci, &ir->ir_set->erst_dequeue);
 	deq = xhci_trb_virt_to_dma(ir->event_ring->deq_seg,
 				   ir->event_ring->dequeue);
 	if (deq == 0)
@@ -3038,9 +3037,15 @@ static void xhci_update_erst_dequeue(struct xhci_hcd *xhci,
 	/*
 	 * Per 4.9.4, Software writes to the ERDP register shall always advance
 	 * the Event Ring Dequeue Pointer value.
+	 *
+	 * The EHB clear at the end of event handling is written unconditionally,
+	 * so only read back the current ERDP when the write may be skipped.
 	 */
-	if ((temp_64 & ERST_PTR_MASK) == (deq & ERST_PTR_MASK) && !clear_ehb)
-		return;
+	if (!clear_ehb) {
+		temp_64 = xhci_read_64(xhci, &ir->ir_set->erst_dequeue);
+		if ((temp_64 & ERST_PTR_MASK) == (deq & ERST_PTR_MASK))
+			return;
+	}
 
 	/* Update HC event ring dequeue pointer */
 	temp_64 = ir->event_ring->deq_seg->num & ERST_DESI_MASK;
@@ -1043,15 +1043,23 @@ static struct bkey_packed *bset_search_write_set(const struct btree *b,
 				struct bset_tree *t,
 				struct bpos *search)
 {
-	unsigned l = 0, r = t->size;
+	struct rw_aux_tree *base = rw_aux_tree(b, t);
+	unsigned l = 0, n = t->size;
 
-	while (l + 1 != r) {
-		unsigned m = (l + r) >> 1;
+	/*
+	 * Branchless binary search: the comparison result only selects the
+	 * next base, which compiles to a conditional move instead of a
+	 * mispredicted branch on every level - and since both possible next
+	 * probes are known, we can prefetch them while we compare:
+	 */
+	while (n > 1) {
+		unsigned half = n >> 1;
 
-		if (bpos_lt(rw_aux_tree(b, t)[m].k, *search))
-			l = m;
-		else
-			r = m;
+		prefetch(&base[l + (half >> 1)]);
+		prefetch(&base[l + half + (half >> 1)]);
+
+		l = bpos_lt(base[l + half].k, *search) ? l + half : l;
+		n -= half;
 	}
 
 	return rw_aux_to_bkey(b, t, l);
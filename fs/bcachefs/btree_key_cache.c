@@ -598,7 +598,8 @@ static unsigned long bch2_btree_key_cache_scan(struct shrinker *shrink,
 	struct bucket_table *tbl;
 	struct bkey_cached *ck;
 	size_t scanned = 0, freed = 0, nr = sc->nr_to_scan;
-	unsigned iter, start;
+	unsigned long skipped_dirty = 0, skipped_accessed = 0, skipped_lock_fail = 0;
+	unsigned iter, start, claimed;
 	int srcu_idx;
 
 	srcu_idx = srcu_read_lock(&c->btree_trans_barrier);
@@ -619,11 +620,20 @@ static unsigned long bch2_btree_key_cache_scan(struct shrinker *shrink,
 		return SHRINK_STOP;
 	}
 
-	iter = bc->shrink_iter;
+	iter = READ_ONCE(bc->shrink_iter);
 	if (iter >= tbl->size)
 		iter = 0;
 	start = iter;
 
+	/*
+	 * With many CPUs in direct reclaim plus kswapd on every node, several
+	 * scans run at once: claim (approximately, one bucket per object) the
+	 * range we're about to walk, so that concurrent scanners start past it
+	 * instead of all fighting over the same bucket locks and six locks:
+	 */
+	claimed = (start + min_t(size_t, nr, tbl->size)) % tbl->size;
+	WRITE_ONCE(bc->shrink_iter, claimed);
+
 	do {
 		struct rhash_head *pos, *next;
 
@@ -634,15 +644,14 @@ static unsigned long bch2_btree_key_cache_scan(struct shrinker *shrink,
 			ck = container_of(pos, struct bkey_cached, hash);
 
 			if (test_bit(BKEY_CACHED_DIRTY, &ck->flags)) {
-				bc->skipped_dirty++;
+				skipped_dirty++;
 			} else if (test_bit(BKEY_CACHED_ACCESSED, &ck->flags)) {
 				clear_bit(BKEY_CACHED_ACCESSED, &ck->flags);
-				bc->skipped_accessed++;
+				skipped_accessed++;
 			} else if (!bkey_cached_lock_for_evict(ck)) {
-				bc->skipped_lock_fail++;
+				skipped_lock_fail++;
 			} else if (bkey_cached_evict(bc, ck)) {
 				bkey_cached_free(bc, ck);
-				bc->freed++;
 				freed++;
 			} else {
 				six_unlock_write(&ck->c.lock);
@@ -661,7 +670,14 @@ static unsigned long bch2_btree_key_cache_scan(struct shrinker *shrink,
 			iter = 0;
 	} while (scanned < nr && iter != start);
 out:
-	bc->shrink_iter = iter;
+	/* Record where we actually stopped, unless someone else moved on: */
+	cmpxchg(&bc->shrink_iter, claimed, iter);
+
+	/* Shared stats are only updated once per scan, not per object: */
+	bc->skipped_dirty	+= skipped_dirty;
+	bc->skipped_accessed	+= skipped_accessed;
+	bc->skipped_lock_fail	+= skipped_lock_fail;
+	bc->freed		+= freed;
 
 	rcu_read_unlock();
 	srcu_read_unlock(&c->btree_trans_barrier, srcu_idx);
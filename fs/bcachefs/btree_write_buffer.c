@@ -114,6 +114,51 @@ static noinline void wb_sort(struct wb_key_ref *base, size_t num)
 	}
 }
 
+/*
+ * Build wb->sorted from wb->flushing.keys, sorted in btree order.
+ *
+ * The btree id is the most significant part of the sort key, so we first
+ * bucket the refs by btree with a counting sort - this costs nothing extra,
+ * since we have to make a pass over the keys to build the refs anyway - and
+ * then heapsort each btree's shard on its own. Each shard is much smaller than
+ * the whole buffer, so this saves comparisons and keeps the heap cache-hot on
+ * backpointer heavy workloads where most of the buffer is in a few btrees.
+ */
+static void wb_sort_by_btree(struct btree_write_buffer *wb)
+{
+	unsigned pos[BTREE_ID_NR] = {};
+	unsigned start = 0;
+
+	darray_for_each(wb->flushing.keys, i) {
+		EBUG_ON(i->btree >= BTREE_ID_NR);
+		pos[i->btree]++;
+	}
+
+	for (unsigned btree = 0; btree < BTREE_ID_NR; btree++) {
+		unsigned nr = pos[btree];
+
+		pos[btree] = start;
+		start += nr;
+	}
+
+	for (size_t i = 0; i < wb->flushing.keys.nr; i++) {
+		struct btree_write_buffered_key *k = &wb->flushing.keys.data[i];
+		struct wb_key_ref *ref = &wb->sorted.data[pos[k->btree]++];
+
+		ref->idx = i;
+		ref->btree = k->btree;
+		memcpy(&ref->pos, &k->k.k.p, sizeof(struct bpos));
+	}
+	wb->sorted.nr = wb->flushing.keys.nr;
+
+	/* pos[btree] now points to the end of that btree's shard: */
+	start = 0;
+	for (unsigned btree = 0; btree < BTREE_ID_NR; btree++) {
+		wb_sort(wb->sorted.data + start, pos[btree] - start);
+		start = pos[btree];
+	}
+}
+
 static noinline int wb_flush_one_slowpath(struct btree_trans *trans,
 					  struct btree_iter *iter,
 					  struct btree_write_buffered_key *wb)
@@ -288,12 +333,7 @@ static int bch2_btree_write_buffer_flush_locked(struct btree_trans *trans)
 	move_keys_from_inc_to_flushing(wb);
 	mutex_unlock(&wb->inc.lock);
 
-	for (size_t i = 0; i < wb->flushing.keys.nr; i++) {
-		wb->sorted.data[i].idx = i;
-		wb->sorted.data[i].btree = wb->flushing.keys.data[i].btree;
-		memcpy(&wb->sorted.data[i].pos, &wb->flushing.keys.data[i].k.k.p, sizeof(struct bpos));
-	}
-	wb->sorted.nr = wb->flushing.keys.nr;
+	wb_sort_by_btree(wb);
 
 	/*
 	 * We first sort so that we can detect and skip redundant updates, and
@@ -309,8 +349,6 @@ static int bch2_btree_write_buffer_flush_locked(struct btree_trans *trans)
 	 * If that happens, simply skip the key so we can optimistically insert
 	 * as many keys as possible in the fast path.
 	 */
-	wb_sort(wb->sorted.data, wb->sorted.nr);
-
 	darray_for_each(wb->sorted, i) {
 		struct btree_write_buffered_key *k = &wb->flushing.keys.data[i->idx];
 
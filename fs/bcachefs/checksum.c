@@ -342,7 +342,14 @@ int __bch2_encrypt_bio(struct bch_fs *c, unsigned type,
 
 	darray_init(&sgl);
 
-	bio_for_each_segment(bv, bio, iter) {
+	/*
+	 * Walk multi-page bvecs rather than single page segments: the skcipher
+	 * scatterwalk handles entries that span pages, and this gives us one
+	 * scatterlist entry per physically contiguous chunk (i.e. per folio for
+	 * buffered writes) - much less per segment overhead in the cipher walk,
+	 * and we usually fit in the preallocated entries:
+	 */
+	bio_for_each_bvec(bv, bio, iter) {
 		struct scatterlist sg = {
 			.page_link	= (unsigned long) bv.bv_page,
 			.offset		= bv.bv_offset,
@@ -178,6 +178,12 @@ int cachefiles_add_cache(struct cachefiles_cache *cache)
 	return ret;
 }
 
+/*
+ * How long the free space figures from the last statfs may be reused for while
+ * the cache is well clear of its culling limits.
+ */
+#define CACHEFILES_SPACE_RECHECK	HZ
+
 /*
  * See if we have space for a number of pages and/or a number of files in the
  * cache
@@ -187,13 +193,37 @@ int cachefiles_has_space(struct cachefiles_cache *cache,
 			 enum cachefiles_has_space_for reason)
 {
 	struct kstatfs stats;
-	u64 b_avail, b_writing;
-	int ret;
-
 	struct path path = {
 		.mnt	= cache->mnt,
 		.dentry	= cache->mnt->mnt_root,
 	};
+	u64 b_avail, b_writing;
+	int ret;
+
+	/*
+	 * This is called for every object created and every write, and a
+	 * statfs of the backing fs each time is expensive with lots of small
+	 * objects.  If the last statfs found us above both "run" levels and we
+	 * aren't culling, then account the files and blocks being requested
+	 * against the figures it returned and only redo the statfs once they
+	 * go stale.  The cached block figure already has the writes that were
+	 * in flight at the time of the statfs taken out, and every block
+	 * admitted since is subtracted from it here, whether or not its write
+	 * has completed yet.  The margin between the run and cull levels means
+	 * that the worst a stale figure can do is start culling a little late.
+	 *
+	 * If we fall through, the files and blocks just subtracted are not
+	 * given back: the statfs below either replaces the cached figures or
+	 * fails and marks them stale.
+	 */
+	if (!test_bit(CACHEFILES_CULLING, &cache->flags) &&
+	    time_before(jiffies, READ_ONCE(cache->space_expiry))) {
+		s64 f_left = atomic64_sub_return(fnr, &cache->f_avail);
+		s64 b_left = atomic64_sub_return(bnr, &cache->b_avail);
+
+		if (f_left >= (s64)cache->frun && b_left >= (s64)cache->brun)
+			return 0;
+	}
 
 	//_enter("{%llu,%llu,%llu,%llu,%llu,%llu},%u,%u",
 	//       (unsigned long long) cache->frun,
@@ -209,6 +239,7 @@ int cachefiles_has_space(struct cachefiles_cache *cache,
 
 	ret = vfs_statfs(&path, &stats);
 	if (ret < 0) {
+		WRITE_ONCE(cache->space_expiry, jiffies);
 		trace_cachefiles_vfs_error(NULL, d_inode(path.dentry), ret,
 					   cachefiles_trace_statfs_error);
 		if (ret == -EIO)
@@ -224,6 +255,10 @@ int cachefiles_has_space(struct cachefiles_cache *cache,
 	else
 		b_avail = 0;
 
+	atomic64_set(&cache->f_avail, stats.f_ffree);
+	atomic64_set(&cache->b_avail, b_avail);
+	WRITE_ONCE(cache->space_expiry, jiffies + CACHEFILES_SPACE_RECHECK);
+
 	//_debug("avail %llu,%llu",
 	//       (unsigned long long)stats.f_ffree,
 	//       (unsigned long long)b_avail);
@@ -115,6 +115,7 @@ static int cachefiles_daemon_open(struct inode *inode, struct file *file)
 	refcount_set(&cache->unbind_pincount, 1);
 	xa_init_flags(&cache->reqs, XA_FLAGS_ALLOC);
 	xa_init_flags(&cache->ondemand_ids, XA_FLAGS_ALLOC1);
+	cache->space_expiry = jiffies;
 
 	/* set default caching limits
 	 * - limit at 1% free space and/or free files
@@ -101,6 +101,9 @@ struct cachefiles_cache {
 	atomic_t			f_released;	/* number of objects released lately */
 	atomic_long_t			b_released;	/* number of blocks released lately */
 	atomic_long_t			b_writing;	/* Number of blocks being written */
+	atomic64_t			f_avail;	/* files free at last statfs, less those since created */
+	atomic64_t			b_avail;	/* blocks free at last statfs, less those since admitted */
+	unsigned long			space_expiry;	/* jiffies at which f/b_avail go stale */
 	unsigned			frun_percent;	/* when to stop culling (% files) */
 	unsigned			fcull_percent;	/* when to start culling (% files) */
 	unsigned			fstop_percent;	/* when to stop allocating (% files) */
@@ -104,34 +104,39 @@ void fscrypt_generate_iv(union fscrypt_iv *iv, u64 index,
 	iv->index = cpu_to_le64(index);
 }
 
-/* Encrypt or decrypt a single "data unit" of file contents. */
-int fscrypt_crypt_data_unit(const struct fscrypt_inode_info *ci,
-			    fscrypt_direction_t rw, u64 index,
-			    struct page *src_page, struct page *dest_page,
-			    unsigned int len, unsigned int offs,
-			    gfp_t gfp_flags)
+static struct skcipher_request *
+fscrypt_alloc_crypt_req(const struct fscrypt_inode_info *ci,
+			struct crypto_wait *wait, gfp_t gfp_flags)
 {
-	union fscrypt_iv iv;
-	struct skcipher_request *req = NULL;
-	DECLARE_CRYPTO_WAIT(wait);
-	struct scatterlist dst, src;
-	struct crypto_skcipher *tfm = ci->ci_enc_key.tfm;
-	int res = 0;
-
-	if (WARN_ON_ONCE(len <= 0))
-		return -EINVAL;
-	if (WARN_ON_ONCE(len % FSCRYPT_CONTENTS_ALIGNMENT != 0))
-		return -EINVAL;
-
-	fscrypt_generate_iv(&iv, index, ci);
+	struct skcipher_request *req;
 
-	req = skcipher_request_alloc(tfm, gfp_flags);
+	req = skcipher_request_alloc(ci->ci_enc_key.tfm, gfp_flags);
 	if (!req)
-		return -ENOMEM;
+		return NULL;
 
 	skcipher_request_set_callback(
 		req, CRYPTO_TFM_REQ_MAY_BACKLOG | CRYPTO_TFM_REQ_MAY_SLEEP,
-		crypto_req_done, &wait);
+		crypto_req_done, wait);
+	return req;
+}
+
+/*
+ * Encrypt or decrypt one data unit using an already allocated request, so that
+ * callers working through several data units only allocate it once.
+ */
+static int fscrypt_crypt_data_unit_req(const struct fscrypt_inode_info *ci,
+				       struct skcipher_request *req,
+				       struct crypto_wait *wait,
+				       fscrypt_direction_t rw, u64 index,
+				       struct page *src_page,
+				       struct page *dest_page,
+				       unsigned int len, unsigned int offs)
+{
+	union fscrypt_iv iv;
+	struct scatterlist dst, src;
+	int res;
+
+	fscrypt_generate_iv(&iv, index, ci);
 
 	sg_init_table(&dst, 1);
 	sg_set_page(&dst, dest_page, len, offs);
@@ -139,10 +144,9 @@ int fscrypt_crypt_data_unit(const struct fscrypt_inode_info *ci,
 	sg_set_page(&src, src_page, len, offs);
 	skcipher_request_set_crypt(req, &src, &dst, len, &iv);
 	if (rw == FS_DECRYPT)
-		res = crypto_wait_req(crypto_skcipher_decrypt(req), &wait);
+		res = crypto_wait_req(crypto_skcipher_decrypt(req), wait);
 	else
-		res = crypto_wait_req(crypto_skcipher_encrypt(req), &wait);
-	skcipher_request_free(req);
+		res = crypto_wait_req(crypto_skcipher_encrypt(req), wait);
 	if (res) {
 		fscrypt_err(ci->ci_inode,
 			    "%scryption failed for data unit %llu: %d",
@@ -152,6 +156,32 @@ int fscrypt_crypt_data_unit(const struct fscrypt_inode_info *ci,
 	return 0;
 }
 
+/* Encrypt or decrypt a single "data unit" of file contents. */
+int fscrypt_crypt_data_unit(const struct fscrypt_inode_info *ci,
+			    fscrypt_direction_t rw, u64 index,
+			    struct page *src_page, struct page *dest_page,
+			    unsigned int len, unsigned int offs,
+			    gfp_t gfp_flags)
+{
+	struct skcipher_request *req;
+	DECLARE_CRYPTO_WAIT(wait);
+	int res;
+
+	if (WARN_ON_ONCE(len <= 0))
+		return -EINVAL;
+	if (WARN_ON_ONCE(len % FSCRYPT_CONTENTS_ALIGNMENT != 0))
+		return -EINVAL;
+
+	req = fscrypt_alloc_crypt_req(ci, &wait, gfp_flags);
+	if (!req)
+		return -ENOMEM;
+
+	res = fscrypt_crypt_data_unit_req(ci, req, &wait, rw, index, src_page,
+					  dest_page, len, offs);
+	skcipher_request_free(req);
+	return res;
+}
+
 /**
  * fscrypt_encrypt_pagecache_blocks() - Encrypt data from a pagecache page
  * @page: the locked pagecache page containing the data to encrypt
@@ -188,10 +218,12 @@ struct page *fscrypt_encrypt_pagecache_blocks(struct page *page,
 	const unsigned int du_bits = ci->ci_data_unit_bits;
 	const unsigned int du_size = 1U << du_bits;
 	struct page *ciphertext_page;
+	struct skcipher_request *req;
+	DECLARE_CRYPTO_WAIT(wait);
 	u64 index = ((u64)page->index << (PAGE_SHIFT - du_bits)) +
 		    (offs >> du_bits);
 	unsigned int i;
-	int err;
+	int err = 0;
 
 	if (WARN_ON_ONCE(!PageLocked(page)))
 		return ERR_PTR(-EINVAL);
@@ -203,14 +235,23 @@ struct page *fscrypt_encrypt_pagecache_blocks(struct page *page,
 	if (!ciphertext_page)
 		return ERR_PTR(-ENOMEM);
 
+	req = fscrypt_alloc_crypt_req(ci, &wait, gfp_flags);
+	if (!req) {
+		fscrypt_free_bounce_page(ciphertext_page);
+		return ERR_PTR(-ENOMEM);
+	}
+
 	for (i = offs; i < offs + len; i += du_size, index++) {
-		err = fscrypt_crypt_data_unit(ci, FS_ENCRYPT, index,
-					      page, ciphertext_page,
-					      du_size, i, gfp_flags);
-		if (err) {
-			fscrypt_free_bounce_page(ciphertext_page);
-			return ERR_PTR(err);
-		}
+		err = fscrypt_crypt_data_unit_req(ci, req, &wait, FS_ENCRYPT,
+						  index, page, ciphertext_page,
+						  du_size, i);
+		if (err)
+			break;
+	}
+	skcipher_request_free(req);
+	if (err) {
+		fscrypt_free_bounce_page(ciphertext_page);
+		return ERR_PTR(err);
 	}
 	SetPagePrivate(ciphertext_page);
 	set_page_private(ciphertext_page, (unsigned long)page);
@@ -272,8 +313,10 @@ int fscrypt_decrypt_pagecache_blocks(struct folio *folio, size_t len,
 	const unsigned int du_size = 1U << du_bits;
 	u64 index = ((u64)folio->index << (PAGE_SHIFT - du_bits)) +
 		    (offs >> du_bits);
+	struct skcipher_request *req;
+	DECLARE_CRYPTO_WAIT(wait);
 	size_t i;
-	int err;
+	int err = 0;
 
 	if (WARN_ON_ONCE(!folio_test_locked(folio)))
 		return -EINVAL;
@@ -281,16 +324,21 @@ int fscrypt_decrypt_pagecache_blocks(struct folio *folio, size_t len,
 	if (WARN_ON_ONCE(len <= 0 || !IS_ALIGNED(len | offs, du_size)))
 		return -EINVAL;
 
+	req = fscrypt_alloc_crypt_req(ci, &wait, GFP_NOFS);
+	if (!req)
+		return -ENOMEM;
+
 	for (i = offs; i < offs + len; i += du_size, index++) {
 		struct page *page = folio_page(folio, i >> PAGE_SHIFT);
 
-		err = fscrypt_crypt_data_unit(ci, FS_DECRYPT, index, page,
-					      page, du_size, i & ~PAGE_MASK,
-					      GFP_NOFS);
+		err = fscrypt_crypt_data_unit_req(ci, req, &wait, FS_DECRYPT,
+						  index, page, page, du_size,
+						  i & ~PAGE_MASK);
 		if (err)
-			return err;
+			break;
 	}
-	return 0;
+	skcipher_request_free(req);
+	return err;
 }
 EXPORT_SYMBOL(fscrypt_decrypt_pagecache_blocks);
 
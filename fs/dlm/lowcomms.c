@@ -122,6 +122,9 @@ struct listen_connection {
 #define DLM_WQ_REMAIN_BYTES(e) (PAGE_SIZE - e->end)
 #define DLM_WQ_LENGTH_BYTES(e) (e->end - e->offset)
 
+/* upper bound of writequeue pages handed to one sendmsg() call */
+#define DLM_SEND_MAX_ENTRIES 8
+
 /* An entry waiting to be sent */
 struct writequeue_entry {
 	struct list_head list;
@@ -1357,15 +1360,15 @@ int dlm_lowcomms_resend_msg(struct dlm_msg *msg)
 	return 0;
 }
 
-/* Send a message */
+/* Send queued messages, gathering up to DLM_SEND_MAX_ENTRIES pages at once */
 static int send_to_sock(struct connection *con)
 {
-	struct writequeue_entry *e;
-	struct bio_vec bvec;
+	struct writequeue_entry *e, *entries[DLM_SEND_MAX_ENTRIES];
+	struct bio_vec bvec[DLM_SEND_MAX_ENTRIES];
 	struct msghdr msg = {
 		.msg_flags = MSG_SPLICE_PAGES | MSG_DONTWAIT | MSG_NOSIGNAL,
 	};
-	int len, offset, ret;
+	int len = 0, nr = 0, completed, ret, i;
 
 	spin_lock_bh(&con->writequeue_lock);
 	e = con_next_wq(con);
@@ -1375,13 +1378,20 @@ static int send_to_sock(struct connection *con)
 		return DLM_IO_END;
 	}
 
-	len = e->len;
-	offset = e->offset;
-	WARN_ON_ONCE(len == 0 && e->users == 0);
+	/* pick up every following entry that is ready to go as well */
+	do {
+		WARN_ON_ONCE(e->len == 0 && e->users == 0);
+		bvec_set_page(&bvec[nr], e->page, e->len, e->offset);
+		entries[nr++] = e;
+		len += e->len;
+		if (nr == DLM_SEND_MAX_ENTRIES ||
+		    list_is_last(&e->list, &con->writequeue))
+			break;
+		e = list_next_entry(e, list);
+	} while (!e->users && e->len);
 	spin_unlock_bh(&con->writequeue_lock);
 
-	bvec_set_page(&bvec, e->page, len, offset);
-	iov_iter_bvec(&msg.msg_iter, ITER_SOURCE, &bvec, 1, len);
+	iov_iter_bvec(&msg.msg_iter, ITER_SOURCE, bvec, nr, len);
 	ret = sock_sendmsg(con->sock, &msg);
 	trace_dlm_send(con->nodeid, ret);
 	if (ret == -EAGAIN || ret == 0) {
@@ -1411,7 +1421,11 @@ static int send_to_sock(struct connection *con)
 	}
 
 	spin_lock_bh(&con->writequeue_lock);
-	writequeue_entry_complete(e, ret);
+	for (i = 0; i < nr && ret > 0; i++) {
+		completed = min_t(int, ret, bvec[i].bv_len);
+		writequeue_entry_complete(entries[i], completed);
+		ret -= completed;
+	}
 	spin_unlock_bh(&con->writequeue_lock);
 
 	return DLM_IO_SUCCESS;
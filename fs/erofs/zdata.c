@@ -106,7 +106,7 @@ struct z_erofs_decompressqueue {
 		struct work_struct work;
 		struct kthread_work kthread_work;
 	} u;
-	bool eio, sync;
+	bool eio, sync, fanned_out;
 };
 
 static inline bool z_erofs_is_inline_pcluster(struct z_erofs_pcluster *pcl)
@@ -1427,6 +1427,59 @@ static int z_erofs_decompress_queue(const struct z_erofs_decompressqueue *io,
 	return err;
 }
 
+/* minimum number of pclusters worth handing to another worker */
+#define Z_EROFS_FANOUT_BATCH	4
+
+static void z_erofs_decompressqueue_work(struct work_struct *work);
+
+/*
+ * A large readahead submits all its pclusters as one chain, which a single
+ * worker would then decompress one by one.  Split long chains into batches
+ * and hand all but the last to other workers so that they're decompressed
+ * on several CPUs at once; pclusters are independent of each other once
+ * their I/O has completed.
+ */
+static void z_erofs_decompressqueue_fanout(struct z_erofs_decompressqueue *bgq)
+{
+	z_erofs_next_pcluster_t owned = bgq->head;
+	unsigned int nr = 0, batch, i;
+
+	while (owned != Z_EROFS_PCLUSTER_TAIL) {
+		owned = READ_ONCE(container_of(owned,
+				struct z_erofs_pcluster, next)->next);
+		++nr;
+	}
+	if (nr < 2 * Z_EROFS_FANOUT_BATCH)
+		return;
+	batch = max_t(unsigned int, Z_EROFS_FANOUT_BATCH,
+		      DIV_ROUND_UP(nr, num_online_cpus()));
+
+	while (nr > batch) {
+		struct z_erofs_decompressqueue *q;
+		struct z_erofs_pcluster *pcl;
+
+		q = kvzalloc(sizeof(*q), GFP_NOIO | __GFP_NOWARN);
+		if (!q)
+			break;
+		q->sb = bgq->sb;
+		q->eio = bgq->eio;
+		q->fanned_out = true;
+		q->head = bgq->head;
+
+		/* detach the first @batch pclusters into the new queue */
+		pcl = container_of(bgq->head, struct z_erofs_pcluster, next);
+		for (i = 1; i < batch; ++i)
+			pcl = container_of(READ_ONCE(pcl->next),
+					   struct z_erofs_pcluster, next);
+		bgq->head = READ_ONCE(pcl->next);
+		WRITE_ONCE(pcl->next, Z_EROFS_PCLUSTER_TAIL);
+		nr -= batch;
+
+		INIT_WORK(&q->u.work, z_erofs_decompressqueue_work);
+		queue_work(z_erofs_workqueue, &q->u.work);
+	}
+}
+
 static void z_erofs_decompressqueue_work(struct work_struct *work)
 {
 	struct z_erofs_decompressqueue *bgq =
@@ -1434,6 +1487,8 @@ static void z_erofs_decompressqueue_work(struct work_struct *work)
 	struct page *pagepool = NULL;
 
 	DBG_BUGON(bgq->head == Z_EROFS_PCLUSTER_TAIL);
+	if (!bgq->fanned_out)
+		z_erofs_decompressqueue_fanout(bgq);
 	z_erofs_decompress_queue(bgq, &pagepool);
 	erofs_release_pages(&pagepool);
 	kvfree(bgq);
@@ -241,13 +241,17 @@ static unsigned int fuse_req_hash(u64 unique)
 
 /*
  * A new request is available, wake fiq->waitq
+ *
+ * Drop fiq->lock before waking: the woken reader immediately takes the lock
+ * to dequeue the request, and would otherwise spin on it while we finish the
+ * wakeup.  The caller holds a reference on the connection, so fiq stays valid.
  */
-static void fuse_dev_wake_and_unlock(struct fuse_iqueue *fiq)
+static void fuse_dev_unlock_and_wake(struct fuse_iqueue *fiq)
 __releases(fiq->lock)
 {
+	spin_unlock(&fiq->lock);
 	wake_up(&fiq->waitq);
 	kill_fasync(&fiq->fasync, SIGIO, POLL_IN);
-	spin_unlock(&fiq->lock);
 }
 
 static void fuse_dev_queue_forget(struct fuse_iqueue *fiq, struct fuse_forget_link *forget)
@@ -256,7 +260,7 @@ static void fuse_dev_queue_forget(struct fuse_iqueue *fiq, struct fuse_forget_li
 	if (fiq->connected) {
 		fiq->forget_list_tail->next = forget;
 		fiq->forget_list_tail = forget;
-		fuse_dev_wake_and_unlock(fiq);
+		fuse_dev_unlock_and_wake(fiq);
 	} else {
 		kfree(forget);
 		spin_unlock(&fiq->lock);
@@ -277,7 +281,7 @@ static void fuse_dev_queue_interrupt(struct fuse_iqueue *fiq, struct fuse_req *r
 			list_del_init(&req->intr_entry);
 			spin_unlock(&fiq->lock);
 		} else  {
-			fuse_dev_wake_and_unlock(fiq);
+			fuse_dev_unlock_and_wake(fiq);
 		}
 	} else {
 		spin_unlock(&fiq->lock);
@@ -291,7 +295,7 @@ static void fuse_dev_queue_req(struct fuse_iqueue *fiq, struct fuse_req *req)
 		if (req->in.h.opcode != FUSE_NOTIFY_REPLY)
 			req->in.h.unique = fuse_get_unique_locked(fiq);
 		list_add_tail(&req->list, &fiq->pending);
-		fuse_dev_wake_and_unlock(fiq);
+		fuse_dev_unlock_and_wake(fiq);
 	} else {
 		spin_unlock(&fiq->lock);
 		req->out.h.error = -ENOTCONN;
@@ -1890,7 +1894,7 @@ static void fuse_resend(struct fuse_conn *fc)
 	}
 	/* iq and pq requests are both oldest to newest */
 	list_splice(&to_queue, &fiq->pending);
-	fuse_dev_wake_and_unlock(fiq);
+	fuse_dev_unlock_and_wake(fiq);
 }
 
 static int fuse_notify_resend(struct fuse_conn *fc)
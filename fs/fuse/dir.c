@@ -1329,6 +1329,21 @@ static int fuse_update_get_attr(struct mnt_idmap *idmap, struct inode *inode,
 
 	if (sync) {
 		forget_all_cached_acls(inode);
+		/*
+		 * Size and timestamps of a passthrough file are owned by the
+		 * backing inode, so unless the server invalidated any other
+		 * attribute, ask the backing inode instead of the server.
+		 */
+		if (IS_ENABLED(CONFIG_FUSE_PASSTHROUGH) &&
+		    fc->passthrough_getattr && stat &&
+		    S_ISREG(inode->i_mode) &&
+		    !(inval_mask & STATX_BASIC_STATS & ~FUSE_STATX_PASSTHROUGH)) {
+			err = fuse_passthrough_getattr(idmap, inode, stat,
+						       request_mask, flags);
+			if (err != -ENOENT)
+				return err;
+			err = 0;
+		}
 		/* Try statx if BTIME is requested */
 		if (!fc->no_statx && (request_mask & ~STATX_BASIC_STATS)) {
 			err = fuse_do_statx(idmap, inode, file, stat);
@@ -860,6 +860,9 @@ struct fuse_conn {
 	/** Passthrough support for read/write IO */
 	unsigned int passthrough:1;
 
+	/** Take size and timestamps of passthrough files from backing inode */
+	unsigned int passthrough_getattr:1;
+
 	/* Use pages instead of pointer for kernel I/O */
 	unsigned int use_pages_for_kvec_io:1;
 
@@ -1201,6 +1204,9 @@ void fuse_wait_aborted(struct fuse_conn *fc);
 /* Attributes possibly changed on data and/or size modification */
 #define FUSE_STATX_MODSIZE	(FUSE_STATX_MODIFY | STATX_SIZE)
 
+/* Attributes of a passthrough file that are taken from the backing inode */
+#define FUSE_STATX_PASSTHROUGH	(FUSE_STATX_MODSIZE | STATX_ATIME | STATX_BTIME)
+
 void fuse_invalidate_attr(struct inode *inode);
 void fuse_invalidate_attr_mask(struct inode *inode, u32 mask);
 
@@ -1495,6 +1501,9 @@ ssize_t fuse_passthrough_splice_write(struct pipe_inode_info *pipe,
 				      struct file *out, loff_t *ppos,
 				      size_t len, unsigned int flags);
 ssize_t fuse_passthrough_mmap(struct file *file, struct vm_area_struct *vma);
+int fuse_passthrough_getattr(struct mnt_idmap *idmap, struct inode *inode,
+			     struct kstat *stat, u32 request_mask,
+			     unsigned int flags);
 
 #ifdef CONFIG_SYSCTL
 extern int fuse_sysctl_register(void);
@@ -129,6 +129,54 @@ ssize_t fuse_passthrough_splice_write(struct pipe_inode_info *pipe,
 	return ret;
 }
 
+/*
+ * Fill @stat for a file in passthrough mode: identity, ownership and mode come
+ * from the (cached) fuse inode as usual, size, blocks and times from the
+ * backing inode, which is where the data is being read and written.
+ *
+ * Returns -ENOENT if the inode has no backing file (anymore), in which case
+ * the caller should ask the server.
+ */
+int fuse_passthrough_getattr(struct mnt_idmap *idmap, struct inode *inode,
+			     struct kstat *stat, u32 request_mask,
+			     unsigned int flags)
+{
+	struct fuse_inode *fi = get_fuse_inode(inode);
+	struct fuse_backing *fb;
+	const struct cred *old_cred;
+	struct kstat bstat;
+	int err;
+
+	spin_lock(&fi->lock);
+	fb = fuse_backing_get(fuse_inode_backing(fi));
+	spin_unlock(&fi->lock);
+	if (!fb)
+		return -ENOENT;
+
+	old_cred = override_creds(fb->cred);
+	err = vfs_getattr(&fb->file->f_path, &bstat, request_mask, flags);
+	revert_creds(old_cred);
+	fuse_backing_put(fb);
+	if (err)
+		return err;
+
+	generic_fillattr(idmap, request_mask, inode, stat);
+	stat->mode = fi->orig_i_mode;
+	stat->ino = fi->orig_ino;
+	stat->size = bstat.size;
+	stat->blocks = bstat.blocks;
+	stat->blksize = bstat.blksize;
+	stat->atime = bstat.atime;
+	stat->mtime = bstat.mtime;
+	stat->ctime = bstat.ctime;
+	if (bstat.result_mask & STATX_BTIME) {
+		stat->btime = bstat.btime;
+		stat->result_mask |= STATX_BTIME;
+	}
+
+	return 0;
+}
+
 ssize_t fuse_passthrough_mmap(struct file *file, struct vm_area_struct *vma)
 {
 	struct fuse_file *ff = file->private_data;
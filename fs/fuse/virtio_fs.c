@@ -98,7 +98,7 @@ struct virtio_fs_req_work {
 
 static int virtio_fs_enqueue_req(struct virtio_fs_vq *fsvq,
 				 struct fuse_req *req, bool in_flight,
-				 gfp_t gfp);
+				 bool kick, gfp_t gfp);
 
 static const struct constant_table dax_param_enums[] = {
 	{"always",	FUSE_DAX_ALWAYS },
@@ -553,11 +553,26 @@ static void virtio_fs_hiprio_done_work(struct work_struct *work)
 	spin_unlock(&fsvq->lock);
 }
 
+/* Notify the device of buffers added with virtio_fs_enqueue_req(..., false) */
+static void virtio_fs_kick(struct virtio_fs_vq *fsvq)
+{
+	bool notify = false;
+
+	spin_lock(&fsvq->lock);
+	if (fsvq->connected)
+		notify = virtqueue_kick_prepare(fsvq->vq);
+	spin_unlock(&fsvq->lock);
+
+	if (notify)
+		virtqueue_notify(fsvq->vq);
+}
+
 static void virtio_fs_request_dispatch_work(struct work_struct *work)
 {
 	struct fuse_req *req;
 	struct virtio_fs_vq *fsvq = container_of(work, struct virtio_fs_vq,
 						 dispatch_work);
+	bool added = false;
 	int ret;
 
 	pr_debug("virtio-fs: worker %s called.\n", __func__);
@@ -575,7 +590,10 @@ static void virtio_fs_request_dispatch_work(struct work_struct *work)
 		fuse_request_end(req);
 	}
 
-	/* Dispatch pending requests */
+	/*
+	 * Dispatch pending requests. Add them all to the virtqueue before
+	 * notifying the device once, rather than taking a VM exit per request.
+	 */
 	while (1) {
 		unsigned int flags;
 
@@ -584,20 +602,22 @@ static void virtio_fs_request_dispatch_work(struct work_struct *work)
 					       struct fuse_req, list);
 		if (!req) {
 			spin_unlock(&fsvq->lock);
-			return;
+			break;
 		}
 		list_del_init(&req->list);
 		spin_unlock(&fsvq->lock);
 
 		flags = memalloc_nofs_save();
-		ret = virtio_fs_enqueue_req(fsvq, req, true, GFP_KERNEL);
+		ret = virtio_fs_enqueue_req(fsvq, req, true, false, GFP_KERNEL);
 		memalloc_nofs_restore(flags);
+		if (!ret)
+			added = true;
 		if (ret < 0) {
 			if (ret == -ENOSPC) {
 				spin_lock(&fsvq->lock);
 				list_add_tail(&req->list, &fsvq->queued_reqs);
 				spin_unlock(&fsvq->lock);
-				return;
+				break;
 			}
 			req->out.h.error = ret;
 			spin_lock(&fsvq->lock);
@@ -608,6 +628,9 @@ static void virtio_fs_request_dispatch_work(struct work_struct *work)
 			fuse_request_end(req);
 		}
 	}
+
+	if (added)
+		virtio_fs_kick(fsvq);
 }
 
 /*
@@ -1370,10 +1393,13 @@ static unsigned int sg_init_fuse_args(struct scatterlist *sg,
 	return total_sgs;
 }
 
-/* Add a request to a virtqueue and kick the device */
+/*
+ * Add a request to a virtqueue and, if @kick, kick the device. Callers adding
+ * a batch pass @kick == false and call virtio_fs_kick() once at the end.
+ */
 static int virtio_fs_enqueue_req(struct virtio_fs_vq *fsvq,
 				 struct fuse_req *req, bool in_flight,
-				 gfp_t gfp)
+				 bool kick, gfp_t gfp)
 {
 	/* requests need at least 4 elements */
 	struct scatterlist *stack_sgs[6];
@@ -1455,7 +1481,7 @@ static int virtio_fs_enqueue_req(struct virtio_fs_vq *fsvq,
 
 	if (!in_flight)
 		inc_in_flight_req(fsvq);
-	notify = virtqueue_kick_prepare(vq);
+	notify = kick && virtqueue_kick_prepare(vq);
 
 	spin_unlock(&fsvq->lock);
 
@@ -1497,7 +1523,7 @@ static void virtio_fs_send_req(struct fuse_iqueue *fiq, struct fuse_req *req)
 		 queue_id);
 
 	fsvq = &fs->vqs[queue_id];
-	ret = virtio_fs_enqueue_req(fsvq, req, false, GFP_ATOMIC);
+	ret = virtio_fs_enqueue_req(fsvq, req, false, true, GFP_ATOMIC);
 	if (ret < 0) {
 		if (ret == -ENOSPC) {
 			/*
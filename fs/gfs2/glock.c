@@ -231,6 +231,16 @@ static void gfs2_glock_add_to_lru(struct gfs2_glock *gl)
 
 static void gfs2_glock_remove_from_lru(struct gfs2_glock *gl)
 {
+	/*
+	 * Glocks in active use are not on the LRU, so don't take the global
+	 * lru_lock on every lookup just to find that out.  GLF_LRU is only
+	 * set under gl_lockref.lock; if we race with that, the glock merely
+	 * stays on the LRU until its next put, and can_free_glock() keeps the
+	 * shrinker away from it while it is referenced.
+	 */
+	if (!test_bit(GLF_LRU, &gl->gl_flags))
+		return;
+
 	spin_lock(&lru_lock);
 	if (test_bit(GLF_LRU, &gl->gl_flags)) {
 		list_del_init(&gl->gl_lru);
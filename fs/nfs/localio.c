@@ -19,6 +19,7 @@
 #include <linux/nfs_common.h>
 #include <linux/nfslocalio.h>
 #include <linux/bvec.h>
+#include <linux/blkdev.h>
 
 #include <linux/nfs.h>
 #include <linux/nfs_fs.h>
@@ -48,6 +49,15 @@ struct nfs_local_fsync_ctx {
 static bool localio_enabled __read_mostly = true;
 module_param(localio_enabled, bool, 0644);
 
+/*
+ * Issue suitably aligned LOCALIO reads and writes as direct I/O against the
+ * nfsd file, rather than copying through the server's page cache as well as
+ * the client's.  Direct reads are submitted asynchronously and completed from
+ * the kiocb completion callback.
+ */
+static bool localio_direct_io __read_mostly;
+module_param(localio_direct_io, bool, 0644);
+
 static inline bool nfs_client_is_local(const struct nfs_client *clp)
 {
 	return !!test_bit(NFS_CS_LOCAL_IO, &clp->cl_flags);
@@ -270,6 +280,21 @@ nfs_local_iocb_free(struct nfs_local_kiocb *iocb)
 	kfree(iocb);
 }
 
+static bool
+nfs_local_iocb_can_dio(struct nfs_pgio_header *hdr, struct file *file)
+{
+	struct super_block *sb = file_inode(file)->i_sb;
+	unsigned int mask;
+
+	if (!READ_ONCE(localio_direct_io) ||
+	    !(file->f_mode & FMODE_CAN_ODIRECT) || !sb->s_bdev)
+		return false;
+
+	/* All but the first bvec start on a page boundary */
+	mask = bdev_logical_block_size(sb->s_bdev) - 1;
+	return !((hdr->args.offset | hdr->args.count | hdr->args.pgbase) & mask);
+}
+
 static struct nfs_local_kiocb *
 nfs_local_iocb_alloc(struct nfs_pgio_header *hdr,
 		     struct file *file, gfp_t flags)
@@ -289,6 +314,8 @@ nfs_local_iocb_alloc(struct nfs_pgio_header *hdr,
 	iocb->kiocb.ki_pos = hdr->args.offset;
 	iocb->hdr = hdr;
 	iocb->kiocb.ki_flags &= ~IOCB_APPEND;
+	if (nfs_local_iocb_can_dio(hdr, file))
+		iocb->kiocb.ki_flags |= IOCB_DIRECT;
 	return iocb;
 }
 
@@ -365,6 +392,26 @@ nfs_local_read_done(struct nfs_local_kiocb *iocb, long status)
 			status > 0 ? status : 0, hdr->res.eof);
 }
 
+static void nfs_local_read_aio_complete_work(struct work_struct *work)
+{
+	struct nfs_local_kiocb *iocb =
+		container_of(work, struct nfs_local_kiocb, work);
+
+	nfs_local_pgio_release(iocb);
+}
+
+/* May be called in interrupt context from the bio completion */
+static void nfs_local_read_aio_complete(struct kiocb *kiocb, long ret)
+{
+	struct nfs_local_kiocb *iocb =
+		container_of(kiocb, struct nfs_local_kiocb, kiocb);
+
+	nfs_local_read_done(iocb, ret);
+
+	INIT_WORK(&iocb->work, nfs_local_read_aio_complete_work);
+	queue_work(nfsiod_workqueue, &iocb->work);
+}
+
 static void nfs_local_call_read(struct work_struct *work)
 {
 	struct nfs_local_kiocb *iocb =
@@ -379,10 +426,10 @@ static void nfs_local_call_read(struct work_struct *work)
 	nfs_local_iter_init(&iter, iocb, READ);
 
 	status = filp->f_op->read_iter(&iocb->kiocb, &iter);
-	WARN_ON_ONCE(status == -EIOCBQUEUED);
-
-	nfs_local_read_done(iocb, status);
-	nfs_local_pgio_release(iocb);
+	if (status != -EIOCBQUEUED) {
+		nfs_local_read_done(iocb, status);
+		nfs_local_pgio_release(iocb);
+	}
 
 	revert_creds(save_cred);
 }
@@ -406,6 +453,8 @@ nfs_do_local_read(struct nfs_pgio_header *hdr,
 	if (iocb == NULL)
 		return -ENOMEM;
 	iocb->localio = localio;
+	if (iocb->kiocb.ki_flags & IOCB_DIRECT)
+		iocb->kiocb.ki_complete = nfs_local_read_aio_complete;
 
 	nfs_local_pgio_init(hdr, call_ops);
 	hdr->res.eof = false;
@@ -561,7 +561,7 @@ nfsd_file_gc_worker(struct work_struct *work)
 static unsigned long
 nfsd_file_lru_count(struct shrinker *s, struct shrink_control *sc)
 {
-	return list_lru_count(&nfsd_file_lru);
+	return list_lru_shrink_count(&nfsd_file_lru, sc);
 }
 
 static unsigned long
@@ -769,7 +769,7 @@ nfsd_file_cache_init(void)
 		goto out_err;
 	}
 
-	nfsd_file_shrinker = shrinker_alloc(0, "nfsd-filecache");
+	nfsd_file_shrinker = shrinker_alloc(SHRINKER_NUMA_AWARE, "nfsd-filecache");
 	if (!nfsd_file_shrinker) {
 		ret = -ENOMEM;
 		pr_err("nfsd: failed to allocate nfsd_file_shrinker\n");
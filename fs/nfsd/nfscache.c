@@ -29,11 +29,16 @@
  */
 #define TARGET_BUCKET_SIZE	64
 
+/*
+ * Every request takes its bucket's lock, so keep each bucket on its own
+ * cacheline: nfsd threads working on neighbouring buckets must not bounce
+ * each other's locks.
+ */
 struct nfsd_drc_bucket {
 	struct rb_root rb_head;
 	struct list_head lru_head;
 	spinlock_t cache_lock;
-};
+} ____cacheline_aligned_in_smp;
 
 static struct kmem_cache	*drc_slab;
 
@@ -443,15 +448,19 @@ nfsd_cache_insert(struct nfsd_drc_bucket *b, struct nfsd_cacherep *key,
 	rb_link_node(&key->c_node, parent, p);
 	rb_insert_color(&key->c_node, &b->rb_head);
 out:
-	/* tally hash chain length stats */
+	/*
+	 * Tally hash chain length stats. These are shared by every bucket, so
+	 * only dirty their cacheline when they actually change.
+	 */
 	if (entries > nn->longest_chain) {
 		nn->longest_chain = entries;
 		nn->longest_chain_cachesize = atomic_read(&nn->num_drc_entries);
 	} else if (entries == nn->longest_chain) {
 		/* prefer to keep the smallest cachesize possible here */
-		nn->longest_chain_cachesize = min_t(unsigned int,
-				nn->longest_chain_cachesize,
-				atomic_read(&nn->num_drc_entries));
+		unsigned int cachesize = atomic_read(&nn->num_drc_entries);
+
+		if (cachesize < nn->longest_chain_cachesize)
+			nn->longest_chain_cachesize = cachesize;
 	}
 
 	lru_put_end(b, ret);
@@ -4373,12 +4373,60 @@ static void ocfs2_schedule_blocked_lock(struct ocfs2_super *osb,
 	spin_unlock_irqrestore(&osb->dc_task_lock, flags);
 }
 
+/* How many inodes ocfs2_downconvert_start_writeback() flushes per pass */
+#define OCFS2_DC_WRITEBACK_BATCH	32
+
+/*
+ * Start writeback of every dirty regular file whose inode lock is queued for
+ * downconvert from EX, before any of them is processed.
+ * ocfs2_data_convert_worker() writes out and waits on one inode at a time, so
+ * without this a node giving up thousands of locks does its I/O serially while
+ * the other node waits.  The worker still does the full sync; this only gets
+ * the I/O going early.
+ */
+static void ocfs2_downconvert_start_writeback(struct ocfs2_super *osb)
+{
+	struct inode *inodes[OCFS2_DC_WRITEBACK_BATCH];
+	struct ocfs2_lock_res *lockres;
+	struct inode *inode;
+	unsigned long flags;
+	int i, nr = 0;
+
+	spin_lock_irqsave(&osb->dc_task_lock, flags);
+	list_for_each_entry(lockres, &osb->blocked_lock_list, l_blocked_list) {
+		if (lockres->l_ops != &ocfs2_inode_inode_lops ||
+		    lockres->l_level != DLM_LOCK_EX)
+			continue;
+
+		inode = ocfs2_lock_res_inode(lockres);
+		if (!S_ISREG(inode->i_mode) ||
+		    !mapping_tagged(inode->i_mapping, PAGECACHE_TAG_DIRTY))
+			continue;
+
+		inode = igrab(inode);
+		if (!inode)
+			continue;
+
+		inodes[nr++] = inode;
+		if (nr == OCFS2_DC_WRITEBACK_BATCH)
+			break;
+	}
+	spin_unlock_irqrestore(&osb->dc_task_lock, flags);
+
+	for (i = 0; i < nr; i++)
+		filemap_flush(inodes[i]->i_mapping);
+	for (i = 0; i < nr; i++)
+		iput(inodes[i]);
+}
+
 static void ocfs2_downconvert_thread_do_work(struct ocfs2_super *osb)
 {
 	unsigned long processed;
 	unsigned long flags;
 	struct ocfs2_lock_res *lockres;
 
+	ocfs2_downconvert_start_writeback(osb);
+
 	spin_lock_irqsave(&osb->dc_task_lock, flags);
 	/* grab this early so we know to try again if a state change and
 	 * wake happens part-way through our work  */
@@ -10,6 +10,7 @@
 #include <linux/file.h>
 #include <linux/fileattr.h>
 #include <linux/splice.h>
+#include <linux/pagemap.h>
 #include <linux/xattr.h>
 #include <linux/security.h>
 #include <linux/uaccess.h>
@@ -355,6 +356,16 @@ static int ovl_copy_up_file(struct ovl_fs *ofs, struct dentry *dentry,
 		}
 		WARN_ON(old_pos != new_pos);
 
+		/*
+		 * Start writeback of each chunk as soon as it has been
+		 * copied, so the data lands on disk while the next chunk is
+		 * being read and the fsync below only has the tail to wait
+		 * for.  Errors are picked up by that fsync.
+		 */
+		if (ovl_should_sync(ofs))
+			filemap_fdatawrite_range(new_file->f_mapping,
+						 new_pos - bytes, new_pos - 1);
+
 		len -= bytes;
 	}
 	/* call fsync once, either now or later along with metadata */
@@ -1091,6 +1091,41 @@ static void smap_gather_stats(struct vm_area_struct *vma,
 		walk_page_range(vma->vm_mm, start, vma->vm_end, ops, mss);
 }
 
+/*
+ * smaps_rollup walks large anonymous and file VMAs in pieces of this size, so
+ * that it can drop mmap_lock for a waiting writer without first finishing a
+ * mapping that may be hundreds of gigabytes long.  The pieces end on multiples
+ * of this size, so that no THP mapping straddles two of them and gets
+ * accounted twice.  hugetlb pages can be larger than this, e.g. 16G pages on
+ * powerpc or PUD-level pages on arm64 with 16K or 64K base pages, so hugetlb
+ * VMAs are always walked in one go.
+ */
+#define SMAPS_ROLLUP_CHUNK	SZ_1G
+
+/*
+ * Gather mem stats for at most SMAPS_ROLLUP_CHUNK of @vma, beginning at @start
+ * (or at the start of @vma if it is 0).  Returns the address the walk stopped
+ * at, which is vma->vm_end once the whole VMA has been covered.
+ */
+static unsigned long smap_gather_stats_chunk(struct vm_area_struct *vma,
+		struct mem_size_stats *mss, unsigned long start)
+{
+	unsigned long addr = max(start, vma->vm_start);
+	unsigned long end;
+
+	/* shmem relies on seeing the whole VMA to take its swap shortcut */
+	if ((vma->vm_file && shmem_mapping(vma->vm_file->f_mapping)) ||
+	    is_vm_hugetlb_page(vma) ||
+	    vma->vm_end - addr <= SMAPS_ROLLUP_CHUNK) {
+		smap_gather_stats(vma, mss, start);
+		return vma->vm_end;
+	}
+
+	end = min(vma->vm_end, ALIGN(addr + 1, SMAPS_ROLLUP_CHUNK));
+	walk_page_range(vma->vm_mm, addr, end, &smaps_walk_ops, mss);
+	return end;
+}
+
 #define SEQ_PUT_DEC(str, val) \
 		seq_put_decimal_ull_width(m, str, (val) >> 10, 8)
 
@@ -1193,8 +1228,9 @@ static int show_smaps_rollup(struct seq_file *m, void *v)
 
 	vma_start = vma->vm_start;
 	do {
-		smap_gather_stats(vma, &mss, 0);
-		last_vma_end = vma->vm_end;
+		unsigned long start = 0;
+walk:
+		last_vma_end = smap_gather_stats_chunk(vma, &mss, start);
 
 		/*
 		 * Release mmap_lock temporarily if someone wants to
@@ -1244,7 +1280,12 @@ static int show_smaps_rollup(struct seq_file *m, void *v)
 			 *    vma_next(vmi) will return VMA' whose range
 			 *    contains last_vma_end.
 			 *    Iterate VMA' from last_vma_end.
+			 *
+			 * The walk may also have stopped part way through a
+			 * large VMA, so look up from last_vma_end rather than
+			 * from the end of the VMA we were in.
 			 */
+			vma_iter_set(&vmi, last_vma_end);
 			vma = vma_next(&vmi);
 			/* Case 3 above */
 			if (!vma)
@@ -1252,16 +1293,19 @@ static int show_smaps_rollup(struct seq_file *m, void *v)
 
 			/* Case 1 and 2 above */
 			if (vma->vm_start >= last_vma_end) {
-				smap_gather_stats(vma, &mss, 0);
-				last_vma_end = vma->vm_end;
-				continue;
+				start = 0;
+				goto walk;
 			}
 
 			/* Case 4 above */
 			if (vma->vm_end > last_vma_end) {
-				smap_gather_stats(vma, &mss, last_vma_end);
-				last_vma_end = vma->vm_end;
+				start = last_vma_end;
+				goto walk;
 			}
+		} else if (last_vma_end < vma->vm_end) {
+			/* Carry on with the rest of a large VMA */
+			start = last_vma_end;
+			goto walk;
 		}
 	} for_each_vma(vmi, vma);
 
@@ -134,6 +134,7 @@ ssize_t read_from_oldmem(struct iov_iter *iter, size_t count,
 	unsigned long pfn, offset;
 	ssize_t nr_bytes;
 	ssize_t read = 0, tmp;
+	bool check_ram;
 	int idx;
 
 	if (!count)
@@ -143,6 +144,11 @@ ssize_t read_from_oldmem(struct iov_iter *iter, size_t count,
 	pfn = (unsigned long)(*ppos / PAGE_SIZE);
 
 	idx = srcu_read_lock(&vmcore_cb_srcu);
+	/*
+	 * As in vmcore_remap_oldmem_pfn(), don't walk the callback list for
+	 * every page of a large read if nobody registered one.
+	 */
+	check_ram = !list_empty(&vmcore_cb_list);
 	do {
 		if (count > (PAGE_SIZE - offset))
 			nr_bytes = PAGE_SIZE - offset;
@@ -150,7 +156,7 @@ ssize_t read_from_oldmem(struct iov_iter *iter, size_t count,
 			nr_bytes = count;
 
 		/* If pfn is not ram, return zeros for sparse dump files */
-		if (!pfn_is_ram(pfn)) {
+		if (check_ram && !pfn_is_ram(pfn)) {
 			tmp = iov_iter_zero(nr_bytes, iter);
 		} else {
 			if (encrypted)
@@ -171,6 +177,7 @@ ssize_t read_from_oldmem(struct iov_iter *iter, size_t count,
 		read += nr_bytes;
 		++pfn;
 		offset = 0;
+		cond_resched();
 	} while (count);
 	srcu_read_unlock(&vmcore_cb_srcu, idx);
 
@@ -42,6 +42,7 @@ static struct cached_fid *find_or_create_cached_dir(struct cached_fids *cfids,
 				return NULL;
 			}
 			kref_get(&cfid->refcount);
+			cfid->last_access_time = jiffies;
 			spin_unlock(&cfids->cfid_list_lock);
 			return cfid;
 		}
@@ -346,6 +347,7 @@ int open_cached_dir(unsigned int xid, struct cifs_tcon *tcon,
 		cfid->file_all_info_is_valid = true;
 
 	cfid->time = jiffies;
+	cfid->last_access_time = jiffies;
 	spin_unlock(&cfids->cfid_list_lock);
 	/* At this point the directory handle is fully cached */
 	rc = 0;
@@ -403,6 +405,7 @@ int open_cached_dir_by_dentry(struct cifs_tcon *tcon,
 		if (dentry && cfid->dentry == dentry) {
 			cifs_dbg(FYI, "found a cached file handle by dentry\n");
 			kref_get(&cfid->refcount);
+			cfid->last_access_time = jiffies;
 			*ret_cfid = cfid;
 			spin_unlock(&cfids->cfid_list_lock);
 			return 0;
@@ -703,8 +706,15 @@ static void cfids_laundromat_worker(struct work_struct *work)
 
 	spin_lock(&cfids->cfid_list_lock);
 	list_for_each_entry_safe(cfid, q, &cfids->entries, entry) {
+		/*
+		 * Only expire directories that have not been used for
+		 * dir_cache_timeout.  While we hold the lease the server
+		 * tells us about changes, so there is no reason to drop a
+		 * handle that is still being looked up in.
+		 */
 		if (cfid->time &&
-		    time_after(jiffies, cfid->time + HZ * dir_cache_timeout)) {
+		    time_after(jiffies, cfid->last_access_time +
+					HZ * dir_cache_timeout)) {
 			cfid->on_list = false;
 			list_move(&cfid->entry, &entry);
 			cfids->num_entries--;
@@ -224,7 +224,7 @@ static bool is_compressible(const struct iov_iter *data)
 {
 	const size_t read_size = SZ_2K, bkt_size = 256, max = SZ_4M;
 	struct bucket *bkt = NULL;
-	size_t len;
+	size_t len, slen;
 	u8 *sample;
 	bool ret = false;
 	int i;
@@ -237,7 +237,12 @@ static bool is_compressible(const struct iov_iter *data)
 	if (len - read_size > max)
 		len = max;
 
-	sample = kvzalloc(len, GFP_KERNEL);
+	/*
+	 * collect_sample() copies at most @read_size bytes out of each page it visits, so there is
+	 * no need to allocate (let alone zero) a buffer the size of the whole write.
+	 */
+	slen = min(len, (len / PAGE_SIZE + 2) * read_size);
+	sample = kvmalloc(slen, GFP_KERNEL);
 	if (!sample) {
 		WARN_ON_ONCE(1);
 
@@ -329,7 +334,7 @@ int smb_compress(struct TCP_Server_Info *server, struct smb_rqst *rq, compress_s
 		return -EINVAL;
 
 	slen = iov_iter_count(&rq->rq_iter);
-	src = kvzalloc(slen, GFP_KERNEL);
+	src = kvmalloc(slen, GFP_KERNEL);
 	if (!src) {
 		ret = -ENOMEM;
 		goto err_free;
@@ -345,10 +350,10 @@ int smb_compress(struct TCP_Server_Info *server, struct smb_rqst *rq, compress_s
 
 	/*
 	 * This is just overprovisioning, as the algorithm will error out if @dst reaches 7/8
-	 * of @slen.
+	 * of @slen.  Both buffers are fully written before being read, so skip zeroing them.
 	 */
 	dlen = slen;
-	dst = kvzalloc(dlen, GFP_KERNEL);
+	dst = kvmalloc(dlen, GFP_KERNEL);
 	if (!dst) {
 		ret = -ENOMEM;
 		goto err_free;
@@ -305,6 +305,12 @@ struct smbd_mr *smbd_register_mr(
 	bool writing, bool need_invalidate);
 int smbd_deregister_mr(struct smbd_mr *mr);
 
+/* True if large I/O on this connection would have to wait for an MR */
+static inline bool smbd_mr_exhausted(struct smbd_connection *info)
+{
+	return info && !atomic_read(&info->mr_ready_count);
+}
+
 #else
 #define cifs_rdma_enabled(server)	0
 struct smbd_connection {};
@@ -314,6 +320,7 @@ static inline int smbd_reconnect(struct TCP_Server_Info *server) {return -1; }
 static inline void smbd_destroy(struct TCP_Server_Info *server) {}
 static inline int smbd_recv(struct smbd_connection *info, struct msghdr *msg) {return -1; }
 static inline int smbd_send(struct TCP_Server_Info *server, int num_rqst, struct smb_rqst *rqst) {return -1; }
+static inline bool smbd_mr_exhausted(struct smbd_connection *info) {return false; }
 #endif
 
 #endif
@@ -1014,6 +1014,7 @@ struct TCP_Server_Info *cifs_pick_channel(struct cifs_ses *ses)
 {
 	uint index = 0;
 	unsigned int min_in_flight = UINT_MAX, max_in_flight = 0;
+	unsigned int in_flight;
 	struct TCP_Server_Info *server = NULL;
 	int i;
 
@@ -1037,12 +1038,23 @@ struct TCP_Server_Info *cifs_pick_channel(struct cifs_ses *ses)
 		 * taking the lock could help reduce wait time, which is
 		 * important for this function
 		 */
-		if (server->in_flight < min_in_flight) {
-			min_in_flight = server->in_flight;
+		in_flight = server->in_flight;
+
+		/*
+		 * An SMB Direct channel with no free memory registrations
+		 * makes RDMA reads and writes sleep in get_mr() however
+		 * lightly loaded it looks, so only pick it if every channel
+		 * is in the same state.
+		 */
+		if (server->rdma && smbd_mr_exhausted(server->smbd_conn))
+			in_flight = UINT_MAX - 1;
+
+		if (in_flight < min_in_flight) {
+			min_in_flight = in_flight;
 			index = i;
 		}
-		if (server->in_flight > max_in_flight)
-			max_in_flight = server->in_flight;
+		if (in_flight > max_in_flight)
+			max_in_flight = in_flight;
 	}
 
 	/* if all channels are equally loaded, fall back to round-robin */
@@ -404,8 +404,14 @@ static int squashfs_fill_super(struct super_block *sb, struct fs_context *fc)
 	if (fragments == 0)
 		goto check_directory_table;
 
+	/*
+	 * Every decompressor thread may be working on a different fragment
+	 * block, so size the fragment cache to match rather than having the
+	 * readers queue up behind a handful of entries.
+	 */
 	msblk->fragment_cache = squashfs_cache_init("fragment",
-		SQUASHFS_CACHED_FRAGMENTS, msblk->block_size);
+		max(SQUASHFS_CACHED_FRAGMENTS, msblk->max_thread_num),
+		msblk->block_size);
 	if (msblk->fragment_cache == NULL) {
 		err = -ENOMEM;
 		goto failed_mount;
@@ -621,6 +621,28 @@ xchk_scrub_create_subord(
 	return sub;
 }
 
+/*
+ * If the administrator has set fs.xfs.scrub_throttle_ms, sleep for that long
+ * before each scrub call so that a background scrub of a busy filesystem runs
+ * at a bounded duty cycle and leaves the disks to the foreground workload.
+ * This must only be called before setup, while we hold no buffers, locks or
+ * transactions that the foreground workload could end up waiting on.
+ */
+static int
+xchk_throttle(void)
+{
+	unsigned int		throttle_ms;
+
+	throttle_ms = READ_ONCE(xfs_params.scrub_throttle.val);
+	if (!throttle_ms)
+		return 0;
+
+	schedule_timeout_killable(msecs_to_jiffies(throttle_ms));
+	if (fatal_signal_pending(current))
+		return -EINTR;
+	return 0;
+}
+
 /* Dispatch metadata scrubbing. */
 STATIC int
 xfs_scrub_metadata(
@@ -652,6 +674,10 @@ xfs_scrub_metadata(
 
 	xfs_warn_experimental(mp, XFS_EXPERIMENTAL_SCRUB);
 
+	error = xchk_throttle();
+	if (error)
+		goto out;
+
 	sc = kzalloc(sizeof(struct xfs_scrub), XCHK_GFP_FLAGS);
 	if (!sc) {
 		error = -ENOMEM;
@@ -75,9 +75,11 @@ xfs_buf_is_vmapped(
 	 *
 	 * b_addr is null if the buffer is not mapped, but the code is clever
 	 * enough to know it doesn't have to map a single page, so the check has
-	 * to be both for b_addr and bp->b_page_count > 1.
+	 * to be both for b_addr and bp->b_page_count > 1.  Buffers backed by a
+	 * single folio are addressed directly and never vmapped either.
 	 */
-	return bp->b_addr && bp->b_page_count > 1;
+	return bp->b_addr && bp->b_page_count > 1 &&
+		!(bp->b_flags & _XBF_FOLIO);
 }
 
 static inline int
@@ -286,19 +288,26 @@ xfs_buf_free_pages(
 
 	ASSERT(bp->b_flags & _XBF_PAGES);
 
-	if (xfs_buf_is_vmapped(bp))
-		vm_unmap_ram(bp->b_addr, bp->b_page_count);
+	if (bp->b_flags & _XBF_FOLIO) {
+		struct folio	*folio = page_folio(bp->b_pages[0]);
 
-	for (i = 0; i < bp->b_page_count; i++) {
-		if (bp->b_pages[i])
-			__free_page(bp->b_pages[i]);
+		mm_account_reclaimed_pages(folio_nr_pages(folio));
+		folio_put(folio);
+	} else {
+		if (xfs_buf_is_vmapped(bp))
+			vm_unmap_ram(bp->b_addr, bp->b_page_count);
+
+		for (i = 0; i < bp->b_page_count; i++) {
+			if (bp->b_pages[i])
+				__free_page(bp->b_pages[i]);
+		}
+		mm_account_reclaimed_pages(bp->b_page_count);
 	}
-	mm_account_reclaimed_pages(bp->b_page_count);
 
 	if (bp->b_pages != bp->b_page_array)
 		kfree(bp->b_pages);
 	bp->b_pages = NULL;
-	bp->b_flags &= ~_XBF_PAGES;
+	bp->b_flags &= ~(_XBF_PAGES | _XBF_FOLIO);
 }
 
 static void
@@ -360,6 +369,35 @@ xfs_buf_alloc_kmem(
 	return 0;
 }
 
+/*
+ * Try to back a multi-page buffer with a single high-order folio.  Such a
+ * buffer is physically contiguous, so it can be addressed directly and never
+ * needs to be vmapped.  This is opportunistic: if the allocation can't be
+ * satisfied without reclaim or compaction, fall back to individual pages.
+ */
+static bool
+xfs_buf_alloc_folio(
+	struct xfs_buf	*bp,
+	gfp_t		gfp_mask)
+{
+	unsigned int	order = get_order(BBTOB(bp->b_length));
+	struct folio	*folio;
+	unsigned int	i;
+
+	if (order > MAX_PAGE_ORDER)
+		return false;
+
+	folio = folio_alloc(gfp_mask | __GFP_NORETRY, order);
+	if (!folio)
+		return false;
+
+	for (i = 0; i < bp->b_page_count; i++)
+		bp->b_pages[i] = folio_page(folio, i);
+	bp->b_flags |= _XBF_FOLIO;
+	XFS_STATS_INC(bp->b_mount, xb_page_found);
+	return true;
+}
+
 static int
 xfs_buf_alloc_pages(
 	struct xfs_buf	*bp,
@@ -387,6 +425,9 @@ xfs_buf_alloc_pages(
 	if (!(flags & XBF_READ))
 		gfp_mask |= __GFP_ZERO;
 
+	if (bp->b_page_count > 1 && xfs_buf_alloc_folio(bp, gfp_mask))
+		return 0;
+
 	/*
 	 * Bulk filling of pages can take multiple calls. Not filling the entire
 	 * array is not an allocation failure, so don't back off if we get at
@@ -428,6 +469,9 @@ _xfs_buf_map_pages(
 	if (bp->b_page_count == 1) {
 		/* A single page buffer is always mappable */
 		bp->b_addr = page_address(bp->b_pages[0]);
+	} else if (bp->b_flags & _XBF_FOLIO) {
+		/* A folio is contiguous, use it directly even if unmapped */
+		bp->b_addr = folio_address(page_folio(bp->b_pages[0]));
 	} else if (flags & XBF_UNMAPPED) {
 		bp->b_addr = NULL;
 	} else {
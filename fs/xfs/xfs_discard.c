@@ -131,25 +131,44 @@ xfs_discard_extents(
 	struct xfs_mount	*mp,
 	struct xfs_busy_extents	*extents)
 {
-	struct xfs_extent_busy	*busyp;
+	struct xfs_extent_busy	*busyp, *next;
 	struct bio		*bio = NULL;
 	struct blk_plug		plug;
 	int			error = 0;
 
 	blk_start_plug(&plug);
 	list_for_each_entry(busyp, &extents->extent_list, list) {
-		trace_xfs_discard_extent(busyp->group, busyp->bno,
-				busyp->length);
+		xfs_agblock_t	bno = busyp->bno;
+		xfs_filblks_t	length = busyp->length;
+
+		/*
+		 * The list is sorted by group and block number, so extents
+		 * freed next to each other, possibly by different transactions
+		 * in the checkpoint, are adjacent here.  Issue one discard for
+		 * each such run instead of one per busy extent, keeping each
+		 * run within the size of a single extent.
+		 */
+		while (!list_is_last(&busyp->list, &extents->extent_list)) {
+			next = list_next_entry(busyp, list);
+			if (next->group != busyp->group ||
+			    next->bno != bno + length ||
+			    length + next->length > XFS_MAX_BMBT_EXTLEN)
+				break;
+			length += next->length;
+			busyp = next;
+		}
+
+		trace_xfs_discard_extent(busyp->group, bno, length);
 
 		error = __blkdev_issue_discard(xfs_group_bdev(busyp->group),
-				xfs_gbno_to_daddr(busyp->group, busyp->bno),
-				XFS_FSB_TO_BB(mp, busyp->length),
+				xfs_gbno_to_daddr(busyp->group, bno),
+				XFS_FSB_TO_BB(mp, length),
 				GFP_KERNEL, &bio);
 		if (error && error != -EOPNOTSUPP) {
 			xfs_info(mp,
-	 "discard failed for extent [0x%llx,%u], error %d",
-				 (unsigned long long)busyp->bno,
-				 busyp->length,
+	 "discard failed for extent [0x%llx,%llu], error %d",
+				 (unsigned long long)bno,
+				 (unsigned long long)length,
 				 error);
 			break;
 		}
@@ -10,7 +10,7 @@
  * Tunable XFS parameters.  xfs_params is required even when CONFIG_SYSCTL=n,
  * other XFS code uses these values.  Times are measured in centisecs (i.e.
  * 100ths of a second) with the exception of blockgc_timer, which is measured
- * in seconds.
+ * in seconds, and scrub_throttle, which is measured in milliseconds.
  */
 xfs_param_t xfs_params = {
 			  /*	MIN		DFLT		MAX	*/
@@ -30,6 +30,7 @@ xfs_param_t xfs_params = {
 	.inherit_nodfrg	= {	0,		1,		1	},
 	.fstrm_timer	= {	1,		30*100,		3600*100},
 	.blockgc_timer	= {	1,		300,		3600*24},
+	.scrub_throttle	= {	0,		0,		1000	},
 };
 
 struct xfs_globals xfs_globals = {
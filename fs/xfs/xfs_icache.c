@@ -505,6 +505,15 @@ xfs_inodegc_wait_all(
 	return error;
 }
 
+/*
+ * States in which a cached inode can't be handed out without further work or
+ * waiting.  None of these can be set while the inode has a reference, except
+ * for XFS_INEW on an inode that was just recycled.
+ */
+#define XFS_IGET_HIT_SKIP_FLAGS \
+	(XFS_INEW | XFS_IRECLAIM | XFS_IRECLAIMABLE | XFS_NEED_INACTIVE | \
+	 XFS_INACTIVATING)
+
 /*
  * Check the validity of the inode we just found it the cache
  */
@@ -520,6 +529,29 @@ xfs_iget_cache_hit(
 	struct xfs_mount	*mp = ip->i_mount;
 	int			error;
 
+	/*
+	 * Fast path for a fully set up inode that somebody else already holds
+	 * a reference to, which is the common case for hot inodes.  Inodes with
+	 * a nonzero i_count can't be reclaimed or recycled, so if we manage to
+	 * add a reference we only need to make sure the inode wasn't recycled
+	 * into XFS_INEW state between our unlocked checks and taking it.
+	 */
+	if (!(flags & XFS_IGET_CREATE) &&
+	    READ_ONCE(ip->i_ino) == ino &&
+	    !(READ_ONCE(ip->i_flags) & XFS_IGET_HIT_SKIP_FLAGS) &&
+	    READ_ONCE(inode->i_mode) != 0 &&
+	    atomic_inc_not_zero(&inode->i_count)) {
+		rcu_read_unlock();
+		if (unlikely(READ_ONCE(ip->i_flags) & XFS_IGET_HIT_SKIP_FLAGS)) {
+			iput(inode);
+			trace_xfs_iget_skip(ip);
+			XFS_STATS_INC(mp, xs_ig_frecycle);
+			return -EAGAIN;
+		}
+		trace_xfs_iget_hit(ip);
+		goto out_found;
+	}
+
 	/*
 	 * check for re-use of an inode within an RCU grace period due to the
 	 * radix tree nodes not being updated yet. We monitor for this by
@@ -593,10 +625,11 @@ xfs_iget_cache_hit(
 		trace_xfs_iget_hit(ip);
 	}
 
+out_found:
 	if (lock_flags != 0)
 		xfs_ilock(ip, lock_flags);
 
-	if (!(flags & XFS_IGET_INCORE))
+	if (!(flags & XFS_IGET_INCORE) && (READ_ONCE(ip->i_flags) & XFS_ISTALE))
 		xfs_iflags_clear(ip, XFS_ISTALE);
 	XFS_STATS_INC(mp, xs_ig_found);
 
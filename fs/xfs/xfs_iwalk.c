@@ -61,6 +61,9 @@ struct xfs_iwalk_ag {
 	/* What was the last inode number we saw when iterating the inobt? */
 	xfs_ino_t			lastino;
 
+	/* First inode number that we have not yet started readahead for. */
+	xfs_ino_t			ra_nextino;
+
 	/* Array of inobt records we cache. */
 	struct xfs_inobt_rec_incore	*recs;
 
@@ -122,6 +125,38 @@ xfs_iwalk_ichunk_ra(
 	blk_finish_plug(&plug);
 }
 
+/*
+ * The inobt record cache is full and we are about to drop the cursor to run
+ * the callbacks.  Peek at the next cache's worth of inobt records and start
+ * readahead of their inode clusters now, so that those reads are in flight
+ * while the callbacks process the current batch instead of being issued
+ * only after the callbacks are done.  This is purely advisory; the cursor is
+ * repositioned from @lastino afterwards and any error will be found again
+ * by the real walk.
+ */
+STATIC void
+xfs_iwalk_ra_ahead(
+	struct xfs_iwalk_ag		*iwag,
+	struct xfs_btree_cur		*cur)
+{
+	struct xfs_inobt_rec_incore	irec;
+	unsigned int			i;
+	int				has_more;
+
+	for (i = 0; i < iwag->sz_recs; i++) {
+		if (xfs_btree_increment(cur, 0, &has_more) || !has_more)
+			return;
+		if (xfs_inobt_get_rec(cur, &irec, &has_more) || !has_more)
+			return;
+		if (irec.ir_freecount == irec.ir_count)
+			continue;
+
+		xfs_iwalk_ichunk_ra(iwag->mp, iwag->pag, &irec);
+		iwag->ra_nextino = xfs_agino_to_ino(iwag->pag,
+				irec.ir_startino + XFS_INODES_PER_CHUNK);
+	}
+}
+
 /*
  * Set the bits in @irec's free mask that correspond to the inodes before
  * @agino so that we skip them.  This is how we restart an inode walk that was
@@ -443,9 +478,9 @@ xfs_iwalk_ag(
 
 		/*
 		 * Start readahead for this inode chunk in anticipation of
-		 * walking the inodes.
+		 * walking the inodes, unless xfs_iwalk_ra_ahead() already did.
 		 */
-		if (iwag->iwalk_fn)
+		if (iwag->iwalk_fn && rec_fsino >= iwag->ra_nextino)
 			xfs_iwalk_ichunk_ra(mp, pag, irec);
 
 		/*
@@ -466,6 +501,8 @@ xfs_iwalk_ag(
 		 * we would be if we had been able to increment like above.
 		 */
 		ASSERT(has_more);
+		if (iwag->iwalk_fn)
+			xfs_iwalk_ra_ahead(iwag, cur);
 		error = xfs_iwalk_run_callbacks(iwag, &cur, &agi_bp, &has_more);
 	}
 
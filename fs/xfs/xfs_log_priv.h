@@ -231,13 +231,19 @@ struct xfs_cil_ctx {
 	struct list_head	iclog_entry;
 	struct list_head	committing;	/* ctx committing list */
 	struct work_struct	push_work;
-	atomic_t		order_id;
+
+	/*
+	 * Every commit bumps order_id, so keep it away from the fields above
+	 * that every commit only reads, otherwise all CPUs committing to the
+	 * context keep stealing that cacheline from each other.
+	 */
+	atomic_t		order_id ____cacheline_aligned_in_smp;
 
 	/*
 	 * CPUs that could have added items to the percpu CIL data.  Access is
 	 * coordinated with xc_ctx_lock.
 	 */
-	struct cpumask		cil_pcpmask;
+	struct cpumask		cil_pcpmask ____cacheline_aligned_in_smp;
 };
 
 /*
@@ -194,6 +194,15 @@ static struct ctl_table xfs_table[] = {
 		.extra1		= &xfs_params.blockgc_timer.min,
 		.extra2		= &xfs_params.blockgc_timer.max,
 	},
+	{
+		.procname	= "scrub_throttle_ms",
+		.data		= &xfs_params.scrub_throttle.val,
+		.maxlen		= sizeof(int),
+		.mode		= 0644,
+		.proc_handler	= proc_dointvec_minmax,
+		.extra1		= &xfs_params.scrub_throttle.min,
+		.extra2		= &xfs_params.scrub_throttle.max,
+	},
 	/* please keep this the last entry */
 #ifdef CONFIG_PROC_FS
 	{
@@ -1268,9 +1268,12 @@ static inline u32 irq_reg_readl(struct irq_chip_generic *gc,
 }
 
 struct irq_matrix;
+typedef unsigned long (*irq_matrix_cost_fn)(unsigned int cpu);
 struct irq_matrix *irq_alloc_matrix(unsigned int matrix_bits,
 				    unsigned int alloc_start,
 				    unsigned int alloc_end);
+void irq_matrix_set_cost(struct irq_matrix *m, irq_matrix_cost_fn cost);
+unsigned long irq_matrix_irq_rate(unsigned int cpu);
 void irq_matrix_online(struct irq_matrix *m);
 void irq_matrix_offline(struct irq_matrix *m);
 void irq_matrix_assign_system(struct irq_matrix *m, unsigned int bit, bool replace);
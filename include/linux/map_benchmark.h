@@ -15,6 +15,15 @@
 #define DMA_MAP_TO_DEVICE       1
 #define DMA_MAP_FROM_DEVICE     2
 
+#define DMA_MAP_SINGLE_MODE     0 /* dma_map_single() */
+#define DMA_MAP_SG_MODE         1 /* dma_map_sg() */
+#define DMA_MAP_PAGE_MODE       2 /* dma_map_page() */
+#define DMA_MAP_BOUNCE_MODE     3 /* swiotlb_map(), always bouncing */
+#define DMA_MAP_MODE_MAX        4
+
+#define DMA_MAP_MAX_GRANULE     1024
+#define DMA_MAP_HIST_BUCKETS    32
+
 struct map_benchmark {
 	__u64 avg_map_100ns; /* average map latency in 100ns */
 	__u64 map_stddev; /* standard deviation of map latency */
@@ -27,5 +36,13 @@ struct map_benchmark {
 	__u32 dma_dir; /* DMA data direction */
 	__u32 dma_trans_ns; /* time for DMA transmission in ns */
 	__u32 granule;  /* how many PAGE_SIZE will do map/unmap once a time */
+	__u32 map_mode; /* which mapping operation to benchmark */
+	__u32 sg_nents; /* scatterlist entries the granule is split into */
+	/*
+	 * latency histograms, bucket i counts operations which took
+	 * [2^(i-1), 2^i) ns, the last bucket also counts anything slower
+	 */
+	__u64 map_hist[DMA_MAP_HIST_BUCKETS];
+	__u64 unmap_hist[DMA_MAP_HIST_BUCKETS];
 };
 #endif /* _KERNEL_DMA_BENCHMARK_H */
@@ -266,6 +266,7 @@ extern int svc_rdma_recvfrom(struct svc_rqst *);
 /* svc_rdma_rw.c */
 extern void svc_rdma_cc_init(struct svcxprt_rdma *rdma,
 			     struct svc_rdma_chunk_ctxt *cc);
+extern void svc_rdma_init_rw_ctxts(struct svcxprt_rdma *rdma);
 extern void svc_rdma_destroy_rw_ctxts(struct svcxprt_rdma *rdma);
 extern void svc_rdma_cc_init(struct svcxprt_rdma *rdma,
 			     struct svc_rdma_chunk_ctxt *cc);
@@ -483,6 +483,7 @@ enum {
 	EVENT_FILE_FL_PID_FILTER_BIT,
 	EVENT_FILE_FL_WAS_ENABLED_BIT,
 	EVENT_FILE_FL_FREED_BIT,
+	EVENT_FILE_FL_SAMPLED_BIT,
 };
 
 extern struct trace_event_file *trace_get_event_file(const char *instance,
@@ -622,6 +623,7 @@ extern int __kprobe_event_add_fields(struct dynevent_cmd *cmd, ...);
  *  PID_FILTER    - When set, the event is filtered based on pid
  *  WAS_ENABLED   - Set when enabled to know to clear trace on module removal
  *  FREED         - File descriptor is freed, all fields should be considered invalid
+ *  SAMPLED       - Only record one in every sample_period hits of the event
  */
 enum {
 	EVENT_FILE_FL_ENABLED		= (1 << EVENT_FILE_FL_ENABLED_BIT),
@@ -636,6 +638,13 @@ enum {
 	EVENT_FILE_FL_PID_FILTER	= (1 << EVENT_FILE_FL_PID_FILTER_BIT),
 	EVENT_FILE_FL_WAS_ENABLED	= (1 << EVENT_FILE_FL_WAS_ENABLED_BIT),
 	EVENT_FILE_FL_FREED		= (1 << EVENT_FILE_FL_FREED_BIT),
+	EVENT_FILE_FL_SAMPLED		= (1 << EVENT_FILE_FL_SAMPLED_BIT),
+};
+
+/* Per-CPU state of an event in sampled mode */
+struct trace_event_sample {
+	unsigned int			count;
+	unsigned long			sampled_out;
 };
 
 struct trace_event_file {
@@ -667,6 +676,8 @@ struct trace_event_file {
 	refcount_t		ref;	/* ref count for opened files */
 	atomic_t		sm_ref;	/* soft-mode reference counter */
 	atomic_t		tm_ref;	/* trigger-mode reference counter */
+	unsigned int		sample_period;
+	struct trace_event_sample __percpu *sample;
 };
 
 #define __TRACE_EVENT_FLAGS(name, value)				\
@@ -726,7 +737,8 @@ bool __trace_trigger_soft_disabled(struct trace_event_file *file);
  * If any triggers without filters are attached to this event, they
  * will be called here. If the event is soft disabled and has no
  * triggers that require testing the fields, it will return true,
- * otherwise false.
+ * otherwise false.  It also returns true for the hits of a sampled
+ * event that are not to be recorded.
  */
 static __always_inline bool
 trace_trigger_soft_disabled(struct trace_event_file *file)
@@ -735,10 +747,12 @@ trace_trigger_soft_disabled(struct trace_event_file *file)
 
 	if (likely(!(eflags & (EVENT_FILE_FL_TRIGGER_MODE |
 			       EVENT_FILE_FL_SOFT_DISABLED |
-			       EVENT_FILE_FL_PID_FILTER))))
+			       EVENT_FILE_FL_PID_FILTER |
+			       EVENT_FILE_FL_SAMPLED))))
 		return false;
 
-	if (likely(eflags & EVENT_FILE_FL_TRIGGER_COND))
+	if (likely((eflags & (EVENT_FILE_FL_TRIGGER_COND |
+			      EVENT_FILE_FL_SAMPLED)) == EVENT_FILE_FL_TRIGGER_COND))
 		return false;
 
 	return __trace_trigger_soft_disabled(file);
@@ -0,0 +1,49 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#undef TRACE_SYSTEM
+#define TRACE_SYSTEM dim
+
+#if !defined(_TRACE_DIM_H) || defined(TRACE_HEADER_MULTI_READ)
+#define _TRACE_DIM_H
+
+#include <linux/dim.h>
+#include <linux/tracepoint.h>
+
+TRACE_EVENT(dim_decision,
+
+	TP_PROTO(const struct dim *dim, const struct dim_stats *stats,
+		 u8 prev_ix),
+
+	TP_ARGS(dim, stats, prev_ix),
+
+	TP_STRUCT__entry(
+		__field(	const void *,	dim)
+		__field(	u8,		prev_ix)
+		__field(	u8,		profile_ix)
+		__field(	u8,		tune_state)
+		__field(	int,		ppms)
+		__field(	int,		bpms)
+		__field(	int,		epms)
+		__field(	int,		cpe_ratio)
+	),
+
+	TP_fast_assign(
+		__entry->dim = dim;
+		__entry->prev_ix = prev_ix;
+		__entry->profile_ix = dim->profile_ix;
+		__entry->tune_state = dim->tune_state;
+		__entry->ppms = stats->ppms;
+		__entry->bpms = stats->bpms;
+		__entry->epms = stats->epms;
+		__entry->cpe_ratio = stats->cpe_ratio;
+	),
+
+	TP_printk("dim %p profile %u -> %u tune_state %u ppms %d bpms %d epms %d cpe_ratio %d",
+		  __entry->dim, __entry->prev_ix, __entry->profile_ix,
+		  __entry->tune_state, __entry->ppms, __entry->bpms,
+		  __entry->epms, __entry->cpe_ratio)
+);
+
+#endif /* _TRACE_DIM_H */
+
+/* This part must be outside protection */
+#include <trace/define_trace.h>
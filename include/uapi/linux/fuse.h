@@ -220,6 +220,9 @@
  *
  *  7.41
  *  - add FUSE_ALLOW_IDMAP
+ *
+ *  7.42
+ *  - add FUSE_PASSTHROUGH_GETATTR
  */
 
 #ifndef _LINUX_FUSE_H
@@ -255,7 +258,7 @@
 #define FUSE_KERNEL_VERSION 7
 
 /** Minor version number of this interface */
-#define FUSE_KERNEL_MINOR_VERSION 41
+#define FUSE_KERNEL_MINOR_VERSION 42
 
 /** The node ID of the root inode */
 #define FUSE_ROOT_ID 1
@@ -425,6 +428,11 @@ struct fuse_file_lock {
  * FUSE_HAS_RESEND: kernel supports resending pending requests, and the high bit
  *		    of the request ID indicates resend requests
  * FUSE_ALLOW_IDMAP: allow creation of idmapped mounts
+ * FUSE_PASSTHROUGH_GETATTR: once cached attributes time out, take size,
+ *			     blocks and timestamps of files with a passthrough
+ *			     backing file from the backing inode instead of
+ *			     sending GETATTR; explicit invalidation of other
+ *			     attributes still goes to the server
  */
 #define FUSE_ASYNC_READ		(1 << 0)
 #define FUSE_POSIX_LOCKS	(1 << 1)
@@ -471,6 +479,7 @@ struct fuse_file_lock {
 /* Obsolete alias for FUSE_DIRECT_IO_ALLOW_MMAP */
 #define FUSE_DIRECT_IO_RELAX	FUSE_DIRECT_IO_ALLOW_MMAP
 #define FUSE_ALLOW_IDMAP	(1ULL << 40)
+#define FUSE_PASSTHROUGH_GETATTR (1ULL << 41)
 
 /**
  * CUSE INIT request/reply flags
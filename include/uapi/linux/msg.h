@@ -14,6 +14,9 @@
 #define MSG_EXCEPT      020000  /* recv any msg except of specified type.*/
 #define MSG_COPY        040000  /* copy (not remove) all queue messages */
 
+/* msgsnd options */
+#define MSG_DIRECT      0100000 /* hand over to a waiting receiver without a kernel copy */
+
 /* Obsolete, used only for backwards compatibility and libc5 compiles */
 struct msqid_ds {
 	struct ipc_perm msg_perm;
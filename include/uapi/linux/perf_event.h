@@ -518,7 +518,8 @@ struct perf_event_attr {
 			__u32	aux_start_paused :  1, /* start AUX area tracing paused */
 				aux_pause        :  1, /* on overflow, pause AUX area tracing */
 				aux_resume       :  1, /* on overflow, resume AUX area tracing */
-				__reserved_3     : 29;
+				pause_output     :  1, /* on overflow, pause ring buffer output */
+				__reserved_3     : 28;
 		};
 	};
 
@@ -0,0 +1,43 @@
+/* SPDX-License-Identifier: GPL-2.0 WITH Linux-syscall-note */
+#ifndef _TRACE_HIST_RAW_H_
+#define _TRACE_HIST_RAW_H_
+
+#include <linux/types.h>
+
+#define TRACE_HIST_RAW_MAGIC		0x57415248	/* "HRAW" */
+#define TRACE_HIST_RAW_VERSION		1
+
+/**
+ * struct trace_hist_raw_header - Header of one hist_raw table
+ * @magic:		TRACE_HIST_RAW_MAGIC.
+ * @version:		TRACE_HIST_RAW_VERSION.
+ * @header_size:	Size of this structure, entries start right after it.
+ * @key_size:		Size of the compound key of each entry, in bytes.
+ * @n_vals:		Number of __u64 values of each entry, hitcount first.
+ * @n_entries:		Number of entries following this header.
+ * @entry_size:		Size of each entry: the key padded to 8 bytes,
+ *			followed by @n_vals values.
+ * @hits:		Total number of hits of the histogram.
+ * @drops:		Number of hits dropped because the table was full.
+ *
+ * The hist_raw file of an event contains one table per hist trigger
+ * attached to the event, in the order they are listed in the 'hist'
+ * file.  Entries are not sorted, and values are given in the order of
+ * the trigger's 'values=' list; variables and expressions are not
+ * exported.
+ */
+struct trace_hist_raw_header {
+	__u32	magic;
+	__u16	version;
+	__u16	header_size;
+
+	__u32	key_size;
+	__u32	n_vals;
+	__u32	n_entries;
+	__u32	entry_size;
+
+	__u64	hits;
+	__u64	drops;
+};
+
+#endif /* _TRACE_HIST_RAW_H_ */
@@ -45,4 +45,15 @@ struct trace_buffer_meta {
 
 #define TRACE_MMAP_IOCTL_GET_READER		_IO('R', 0x20)
 
+/**
+ * struct trace_pipe_raw_header - Header of a sub-buffer read from the
+ *				  top level trace_pipe_raw file
+ * @cpu:	CPU of the ring-buffer the sub-buffer was read from.
+ * @size:	Size of the sub-buffer following this header.
+ */
+struct trace_pipe_raw_header {
+	__u32	cpu;
+	__u32	size;
+};
+
 #endif /* _TRACE_MMAP_H_ */
@@ -850,6 +850,8 @@ static long do_msgsnd(int msqid, long mtype, void __user *mtext,
 {
 	struct msg_queue *msq;
 	struct msg_msg *msg;
+	struct msg_direct *direct = NULL;
+	bool pinned = false;
 	int err;
 	struct ipc_namespace *ns;
 	DEFINE_WAKE_Q(wake_q);
@@ -861,13 +863,20 @@ static long do_msgsnd(int msqid, long mtype, void __user *mtext,
 	if (mtype < 1)
 		return -EINVAL;
 
-	msg = load_msg(mtext, msgsz);
+	/* Small messages are cheaper to copy than to pin. */
+	if ((msgflg & MSG_DIRECT) && msgsz > PAGE_SIZE) {
+		msg = load_msg_direct(mtext, msgsz, &direct);
+		pinned = !IS_ERR(msg);
+	} else {
+		msg = load_msg(mtext, msgsz);
+	}
 	if (IS_ERR(msg))
 		return PTR_ERR(msg);
 
 	msg->m_type = mtype;
 	msg->m_ts = msgsz;
 
+retry:
 	rcu_read_lock();
 	msq = msq_obtain_object_check(ns, msqid);
 	if (IS_ERR(msq)) {
@@ -894,7 +903,8 @@ static long do_msgsnd(int msqid, long mtype, void __user *mtext,
 		if (err)
 			goto out_unlock0;
 
-		if (msg_fits_inqueue(msq, msgsz))
+		/* A direct message is never queued, see below. */
+		if (pinned || msg_fits_inqueue(msq, msgsz))
 			break;
 
 		/* queue full, wait: */
@@ -933,10 +943,30 @@ static long do_msgsnd(int msqid, long mtype, void __user *mtext,
 
 	}
 
+	if (pinned && !pipelined_send(msq, msg, &wake_q)) {
+		/*
+		 * Nobody is waiting to take the pinned pages right now, so
+		 * fall back to a regular message that can be queued.
+		 */
+		ipc_unlock_object(&msq->q_perm);
+		rcu_read_unlock();
+		free_msg(msg);
+		msg_direct_put(direct);
+		pinned = false;
+
+		msg = load_msg(mtext, msgsz);
+		if (IS_ERR(msg))
+			return PTR_ERR(msg);
+
+		msg->m_type = mtype;
+		msg->m_ts = msgsz;
+		goto retry;
+	}
+
 	ipc_update_pid(&msq->q_lspid, task_tgid(current));
 	msq->q_stime = ktime_get_real_seconds();
 
-	if (!pipelined_send(msq, msg, &wake_q)) {
+	if (!pinned && !pipelined_send(msq, msg, &wake_q)) {
 		/* no one is waiting for this message, enqueue it */
 		list_add_tail(&msg->m_list, &msq->q_messages);
 		msq->q_cbytes += msgsz;
@@ -955,6 +985,17 @@ static long do_msgsnd(int msqid, long mtype, void __user *mtext,
 	rcu_read_unlock();
 	if (msg != NULL)
 		free_msg(msg);
+	if (pinned) {
+		/*
+		 * The receiver copies straight from the pinned pages, wait
+		 * until it is done with them (free_msg() completes @done).
+		 * The copy can take arbitrarily long if the receiver's buffer
+		 * faults slowly, so let a fatal signal cut the wait short;
+		 * the receiver's reference keeps the pages pinned.
+		 */
+		wait_for_completion_killable(&direct->done);
+		msg_direct_put(direct);
+	}
 	return err;
 }
 
@@ -15,6 +15,8 @@
 #include <linux/proc_ns.h>
 #include <linux/uaccess.h>
 #include <linux/sched.h>
+#include <linux/mm.h>
+#include <linux/highmem.h>
 
 #include "util.h"
 
@@ -65,6 +67,7 @@ static struct msg_msg *alloc_msg(size_t len)
 	if (msg == NULL)
 		return NULL;
 
+	msg->m_ts = 0;
 	msg->next = NULL;
 	msg->security = NULL;
 
@@ -125,6 +128,125 @@ struct msg_msg *load_msg(const void __user *src, size_t len)
 	free_msg(msg);
 	return ERR_PTR(err);
 }
+
+/*
+ * A direct message carries no inline text, the pointer to its pinned
+ * pages is stored where the text would be. It is the only kind of
+ * message that is larger than DATALEN_MSG and still has no segments,
+ * which is how it is told apart without growing struct msg_msg.
+ */
+static struct msg_direct *msg_direct(struct msg_msg *msg)
+{
+	if (msg->m_ts <= DATALEN_MSG || msg->next)
+		return NULL;
+	return *(struct msg_direct **)(msg + 1);
+}
+
+/**
+ * load_msg_direct - pin the text of a message instead of copying it
+ * @src: user space text
+ * @len: size of the text, larger than a page
+ * @dp: returns the pinned pages
+ *
+ * The returned message must only be handed to a receiver that takes it
+ * right away. Both the message and the caller hold a reference on @dp;
+ * free_msg() drops the first and completes @dp->done, the caller drops
+ * the second with msg_direct_put(). The pages stay pinned until both
+ * are gone, so the caller may stop waiting on @dp->done early.
+ */
+struct msg_msg *load_msg_direct(const void __user *src, size_t len,
+				struct msg_direct **dp)
+{
+	unsigned long start = (unsigned long)src;
+	struct msg_direct *d;
+	struct msg_msg *msg;
+	int nr, err;
+
+	d = kmalloc(sizeof(*d), GFP_KERNEL_ACCOUNT);
+	if (!d)
+		return ERR_PTR(-ENOMEM);
+
+	err = -ENOMEM;
+	d->offset = offset_in_page(start);
+	d->nr_pages = DIV_ROUND_UP(d->offset + len, PAGE_SIZE);
+	d->pages = kvmalloc_array(d->nr_pages, sizeof(*d->pages), GFP_KERNEL);
+	if (!d->pages)
+		goto out_free;
+
+	nr = pin_user_pages_fast(start & PAGE_MASK, d->nr_pages, 0, d->pages);
+	if (nr != d->nr_pages) {
+		if (nr > 0)
+			unpin_user_pages(d->pages, nr);
+		err = nr < 0 ? nr : -EFAULT;
+		goto out_free_pages;
+	}
+	refcount_set(&d->refcount, 2);
+	init_completion(&d->done);
+
+	err = -ENOMEM;
+	msg = kmem_buckets_alloc(msg_buckets, sizeof(*msg) + sizeof(d),
+				 GFP_KERNEL);
+	if (msg == NULL)
+		goto out_unpin;
+
+	msg->m_ts = len;
+	msg->next = NULL;
+	msg->security = NULL;
+	*(struct msg_direct **)(msg + 1) = d;
+
+	err = security_msg_msg_alloc(msg);
+	if (err) {
+		/* Drops the message's reference. */
+		free_msg(msg);
+		msg_direct_put(d);
+		return ERR_PTR(err);
+	}
+
+	*dp = d;
+	return msg;
+
+out_unpin:
+	unpin_user_pages(d->pages, d->nr_pages);
+out_free_pages:
+	kvfree(d->pages);
+out_free:
+	kfree(d);
+	return ERR_PTR(err);
+}
+
+void msg_direct_put(struct msg_direct *d)
+{
+	if (!refcount_dec_and_test(&d->refcount))
+		return;
+
+	unpin_user_pages(d->pages, d->nr_pages);
+	kvfree(d->pages);
+	kfree(d);
+}
+
+static int store_msg_direct(void __user *dest, struct msg_direct *d, size_t len)
+{
+	size_t offset = d->offset;
+	unsigned int i;
+
+	for (i = 0; i < d->nr_pages && len; i++) {
+		size_t alen = min(len, PAGE_SIZE - offset);
+		void *src = kmap_local_page(d->pages[i]);
+		unsigned long left;
+
+		left = copy_to_user(dest, src + offset, alen);
+		kunmap_local(src);
+		if (left)
+			return -1;
+
+		dest = (char __user *)dest + alen;
+		len -= alen;
+		offset = 0;
+		cond_resched();
+	}
+	return 0;
+}
+
 #ifdef CONFIG_CHECKPOINT_RESTORE
 struct msg_msg *copy_msg(struct msg_msg *src, struct msg_msg *dst)
 {
@@ -160,9 +282,13 @@ struct msg_msg *copy_msg(struct msg_msg *src, struct msg_msg *dst)
 #endif
 int store_msg(void __user *dest, struct msg_msg *msg, size_t len)
 {
+	struct msg_direct *d = msg_direct(msg);
 	size_t alen;
 	struct msg_msgseg *seg;
 
+	if (d)
+		return store_msg_direct(dest, d, len);
+
 	alen = min(len, DATALEN_MSG);
 	if (copy_to_user(dest, msg + 1, alen))
 		return -1;
@@ -179,10 +305,17 @@ int store_msg(void __user *dest, struct msg_msg *msg, size_t len)
 
 void free_msg(struct msg_msg *msg)
 {
+	struct msg_direct *d = msg_direct(msg);
 	struct msg_msgseg *seg;
 
 	security_msg_msg_free(msg);
 
+	/* Last access to the sender's pages, let it go. */
+	if (d) {
+		complete(&d->done);
+		msg_direct_put(d);
+	}
+
 	seg = msg->next;
 	kfree(msg);
 	while (seg != NULL) {
@@ -1980,6 +1980,38 @@ static struct sem_undo *find_alloc_undo(struct ipc_namespace *ns, int semid)
 	return un;
 }
 
+/**
+ * perform_simple_semop - fast path for an uncontended single sop
+ * @sma: semaphore array, the per-semaphore lock of @sop must be held
+ * @sop: the operation, without SEM_UNDO
+ *
+ * Apply an increment or decrement that succeeds immediately on a semaphore
+ * nobody sleeps on. As no complex operation is around (we hold the
+ * per-semaphore lock), the global queues are empty too, so there is nothing
+ * for do_smart_update() to wake and the queue scans can be skipped.
+ *
+ * Returns 0 if the operation was performed, 1 if the caller has to take
+ * the generic path (wait-for-zero, blocking, error cases or waiters).
+ */
+static int perform_simple_semop(struct sem_array *sma, struct sembuf *sop)
+{
+	int idx = array_index_nospec(sop->sem_num, sma->sem_nsems);
+	struct sem *curr = &sma->sems[idx];
+	int result = curr->semval + sop->sem_op;
+
+	if (!sop->sem_op || result < 0 || result > SEMVMX)
+		return 1;
+
+	if (!list_empty(&curr->pending_alter) ||
+	    !list_empty(&curr->pending_const))
+		return 1;
+
+	curr->semval = result;
+	ipc_update_pid(&curr->sempid, task_tgid(current));
+	curr->sem_otime = ktime_get_real_seconds();
+	return 0;
+}
+
 long __do_semtimedop(int semid, struct sembuf *sops,
 		unsigned nsops, const struct timespec64 *timeout,
 		struct ipc_namespace *ns)
@@ -2091,6 +2123,12 @@ long __do_semtimedop(int semid, struct sembuf *sops,
 	if (un && un->semid == -1)
 		goto out_unlock;
 
+	if (nsops == 1 && !un && locknum != SEM_GLOBAL_LOCK &&
+	    !perform_simple_semop(sma, sops)) {
+		error = 0;
+		goto out_unlock;
+	}
+
 	queue.sops = sops;
 	queue.nsops = nsops;
 	queue.undo = un;
@@ -15,6 +15,8 @@
 #include <linux/err.h>
 #include <linux/ipc_namespace.h>
 #include <linux/pid.h>
+#include <linux/completion.h>
+#include <linux/refcount.h>
 
 /*
  * The IPC ID contains 2 separate numbers - index and sequence number.
@@ -195,8 +197,25 @@ static inline void ipc_update_pid(struct pid **pos, struct pid *pid)
 int ipc_parse_version(int *cmd);
 #endif
 
+/*
+ * Text of a MSG_DIRECT message: the sender's pages stay pinned and the
+ * sender sleeps on @done until the receiver has copied them out. The
+ * pages are unpinned once both the message and the sender have dropped
+ * their reference, so a killed sender can leave before the receiver.
+ */
+struct msg_direct {
+	struct page		**pages;
+	unsigned int		nr_pages;
+	size_t			offset;		/* of the text in pages[0] */
+	refcount_t		refcount;
+	struct completion	done;
+};
+
 extern void free_msg(struct msg_msg *msg);
 extern struct msg_msg *load_msg(const void __user *src, size_t len);
+extern struct msg_msg *load_msg_direct(const void __user *src, size_t len,
+				       struct msg_direct **dp);
+extern void msg_direct_put(struct msg_direct *d);
 extern struct msg_msg *copy_msg(struct msg_msg *src, struct msg_msg *dst);
 extern int store_msg(void __user *dest, struct msg_msg *msg, size_t len);
 
@@ -207,6 +207,15 @@ static struct cgroup *cgroup_rstat_updated_list(struct cgroup *root, int cpu)
 	struct cgroup *head = NULL, *parent, *child;
 	unsigned long flags;
 
+	/*
+	 * Nothing to do if the subtree is clean on @cpu, which is the common
+	 * case for most cgroups on most CPUs. Skip the per-cpu lock then; an
+	 * update racing with this test is no different from one that comes
+	 * right after the flush.
+	 */
+	if (!data_race(rstatc->updated_next))
+		return NULL;
+
 	flags = _cgroup_rstat_cpu_lock(cpu_lock, cpu, root, false);
 
 	/* Return NULL if this subtree is not on-list */
@@ -8,7 +8,10 @@
 #include <linux/debugfs.h>
 #include <linux/delay.h>
 #include <linux/device.h>
+#include <linux/dma-direct.h>
+#include <linux/dma-map-ops.h>
 #include <linux/dma-mapping.h>
+#include <linux/iommu-dma.h>
 #include <linux/kernel.h>
 #include <linux/kthread.h>
 #include <linux/map_benchmark.h>
@@ -16,7 +19,9 @@
 #include <linux/module.h>
 #include <linux/pci.h>
 #include <linux/platform_device.h>
+#include <linux/scatterlist.h>
 #include <linux/slab.h>
+#include <linux/swiotlb.h>
 #include <linux/timekeeping.h>
 
 struct map_benchmark_data {
@@ -29,21 +34,154 @@ struct map_benchmark_data {
 	atomic64_t sum_sq_map;
 	atomic64_t sum_sq_unmap;
 	atomic64_t loops;
+	atomic64_t map_hist[DMA_MAP_HIST_BUCKETS];
+	atomic64_t unmap_hist[DMA_MAP_HIST_BUCKETS];
 };
 
-static int map_benchmark_thread(void *data)
-{
+/* per-thread buffers and mapping state for one benchmark loop */
+struct map_benchmark_ctx {
+	struct map_benchmark_data *map;
+	size_t size;
 	void *buf;
 	dma_addr_t dma_addr;
-	struct map_benchmark_data *map = data;
-	int npages = map->bparam.granule;
-	u64 size = npages * PAGE_SIZE;
-	int ret = 0;
+	struct sg_table sgt;
+};
+
+static int map_benchmark_prepare(struct map_benchmark_ctx *ctx)
+{
+	struct map_benchmark_data *map = ctx->map;
+	unsigned int granule = map->bparam.granule;
+	unsigned int nents = map->bparam.sg_nents;
+	struct scatterlist *sg;
+	int i;
+
+	ctx->size = (size_t)granule * PAGE_SIZE;
+
+	if (map->bparam.map_mode != DMA_MAP_SG_MODE) {
+		ctx->buf = alloc_pages_exact(ctx->size, GFP_KERNEL);
+		return ctx->buf ? 0 : -ENOMEM;
+	}
 
-	buf = alloc_pages_exact(size, GFP_KERNEL);
-	if (!buf)
+	if (sg_alloc_table(&ctx->sgt, nents, GFP_KERNEL))
 		return -ENOMEM;
 
+	/*
+	 * allocate every entry separately so that the scatterlist is not
+	 * physically contiguous, as it would be for real I/O
+	 */
+	for_each_sgtable_sg(&ctx->sgt, sg, i) {
+		size_t len = (granule / nents + (i < granule % nents)) * PAGE_SIZE;
+		void *buf = alloc_pages_exact(len, GFP_KERNEL);
+
+		if (!buf)
+			return -ENOMEM;
+		sg_set_buf(sg, buf, len);
+	}
+
+	return 0;
+}
+
+static void map_benchmark_unprepare(struct map_benchmark_ctx *ctx)
+{
+	struct scatterlist *sg;
+	int i;
+
+	if (ctx->map->bparam.map_mode != DMA_MAP_SG_MODE) {
+		if (ctx->buf)
+			free_pages_exact(ctx->buf, ctx->size);
+		return;
+	}
+
+	/* entries past an allocation failure have no page attached */
+	for_each_sgtable_sg(&ctx->sgt, sg, i) {
+		if (sg_page(sg))
+			free_pages_exact(sg_virt(sg), sg->length);
+	}
+	sg_free_table(&ctx->sgt);
+}
+
+static void map_benchmark_stain(struct map_benchmark_ctx *ctx)
+{
+	struct scatterlist *sg;
+	int i;
+
+	if (ctx->map->bparam.map_mode != DMA_MAP_SG_MODE) {
+		memset(ctx->buf, 0x66, ctx->size);
+		return;
+	}
+
+	for_each_sgtable_sg(&ctx->sgt, sg, i)
+		memset(sg_virt(sg), 0x66, sg->length);
+}
+
+static int map_benchmark_map(struct map_benchmark_ctx *ctx)
+{
+	struct map_benchmark_data *map = ctx->map;
+	struct device *dev = map->dev;
+
+	switch (map->bparam.map_mode) {
+	case DMA_MAP_SG_MODE:
+		return dma_map_sgtable(dev, &ctx->sgt, map->dir, 0);
+	case DMA_MAP_PAGE_MODE:
+		ctx->dma_addr = dma_map_page(dev, virt_to_page(ctx->buf), 0,
+					     ctx->size, map->dir);
+		break;
+	case DMA_MAP_BOUNCE_MODE:
+		if (!IS_ENABLED(CONFIG_SWIOTLB))
+			return -EOPNOTSUPP;
+		ctx->dma_addr = swiotlb_map(dev, virt_to_phys(ctx->buf),
+					    ctx->size, map->dir, 0);
+		break;
+	default:
+		ctx->dma_addr = dma_map_single(dev, ctx->buf, ctx->size,
+					       map->dir);
+		break;
+	}
+
+	if (unlikely(dma_mapping_error(dev, ctx->dma_addr)))
+		return -ENOMEM;
+	return 0;
+}
+
+static void map_benchmark_unmap(struct map_benchmark_ctx *ctx)
+{
+	struct map_benchmark_data *map = ctx->map;
+	struct device *dev = map->dev;
+
+	switch (map->bparam.map_mode) {
+	case DMA_MAP_SG_MODE:
+		dma_unmap_sgtable(dev, &ctx->sgt, map->dir, 0);
+		break;
+	case DMA_MAP_PAGE_MODE:
+		dma_unmap_page(dev, ctx->dma_addr, ctx->size, map->dir);
+		break;
+	case DMA_MAP_BOUNCE_MODE:
+		swiotlb_tbl_unmap_single(dev, dma_to_phys(dev, ctx->dma_addr),
+					 ctx->size, map->dir, 0);
+		break;
+	default:
+		dma_unmap_single(dev, ctx->dma_addr, ctx->size, map->dir);
+		break;
+	}
+}
+
+static void map_benchmark_hist_add(atomic64_t *hist, ktime_t delta)
+{
+	unsigned int bucket = fls64(delta);
+
+	atomic64_inc(&hist[min_t(unsigned int, bucket, DMA_MAP_HIST_BUCKETS - 1)]);
+}
+
+static int map_benchmark_thread(void *data)
+{
+	struct map_benchmark_ctx ctx = { .map = data };
+	struct map_benchmark_data *map = data;
+	int ret;
+
+	ret = map_benchmark_prepare(&ctx);
+	if (ret)
+		goto out;
+
 	while (!kthread_should_stop())  {
 		u64 map_100ns, unmap_100ns, map_sq, unmap_sq;
 		ktime_t map_stime, map_etime, unmap_stime, unmap_etime;
@@ -56,14 +194,13 @@ static int map_benchmark_thread(void *data)
 		 * 66 means evertything goes well! 66 is lucky.
 		 */
 		if (map->dir != DMA_FROM_DEVICE)
-			memset(buf, 0x66, size);
+			map_benchmark_stain(&ctx);
 
 		map_stime = ktime_get();
-		dma_addr = dma_map_single(map->dev, buf, size, map->dir);
-		if (unlikely(dma_mapping_error(map->dev, dma_addr))) {
-			pr_err("dma_map_single failed on %s\n",
+		ret = map_benchmark_map(&ctx);
+		if (unlikely(ret)) {
+			pr_err("dma mapping failed on %s\n",
 				dev_name(map->dev));
-			ret = -ENOMEM;
 			goto out;
 		}
 		map_etime = ktime_get();
@@ -73,7 +210,7 @@ static int map_benchmark_thread(void *data)
 		ndelay(map->bparam.dma_trans_ns);
 
 		unmap_stime = ktime_get();
-		dma_unmap_single(map->dev, dma_addr, size, map->dir);
+		map_benchmark_unmap(&ctx);
 		unmap_etime = ktime_get();
 		unmap_delta = ktime_sub(unmap_etime, unmap_stime);
 
@@ -90,6 +227,9 @@ static int map_benchmark_thread(void *data)
 		atomic64_add(unmap_sq, &map->sum_sq_unmap);
 		atomic64_inc(&map->loops);
 
+		map_benchmark_hist_add(map->map_hist, map_delta);
+		map_benchmark_hist_add(map->unmap_hist, unmap_delta);
+
 		/*
 		 * We may test for a long time so periodically check whether
 		 * we need to schedule to avoid starving the others. Otherwise
@@ -108,7 +248,7 @@ static int map_benchmark_thread(void *data)
 	}
 
 out:
-	free_pages_exact(buf, size);
+	map_benchmark_unprepare(&ctx);
 	return ret;
 }
 
@@ -148,6 +288,10 @@ static int do_map_benchmark(struct map_benchmark_data *map)
 	atomic64_set(&map->sum_sq_map, 0);
 	atomic64_set(&map->sum_sq_unmap, 0);
 	atomic64_set(&map->loops, 0);
+	for (i = 0; i < DMA_MAP_HIST_BUCKETS; i++) {
+		atomic64_set(&map->map_hist[i], 0);
+		atomic64_set(&map->unmap_hist[i], 0);
+	}
 
 	for (i = 0; i < threads; i++) {
 		get_task_struct(tsk[i]);
@@ -190,21 +334,53 @@ static int do_map_benchmark(struct map_benchmark_data *map)
 		map->bparam.unmap_stddev = int_sqrt64(unmap_variance);
 	}
 
+	for (i = 0; i < DMA_MAP_HIST_BUCKETS; i++) {
+		map->bparam.map_hist[i] = atomic64_read(&map->map_hist[i]);
+		map->bparam.unmap_hist[i] = atomic64_read(&map->unmap_hist[i]);
+	}
+
 out:
 	put_device(map->dev);
 	kfree(tsk);
 	return ret;
 }
 
+/* the part of struct map_benchmark that predates map_mode */
+#define DMA_MAP_BENCHMARK_V1_SIZE	offsetofend(struct map_benchmark, granule)
+
+/*
+ * The ioctl number encodes the size of struct map_benchmark, so binaries built
+ * before map_mode and the histograms were added pass a different one.
+ */
+static bool map_benchmark_is_v1_cmd(unsigned int cmd)
+{
+	return _IOC_TYPE(cmd) == _IOC_TYPE(DMA_MAP_BENCHMARK) &&
+	       _IOC_NR(cmd) == _IOC_NR(DMA_MAP_BENCHMARK) &&
+	       _IOC_DIR(cmd) == _IOC_DIR(DMA_MAP_BENCHMARK) &&
+	       _IOC_SIZE(cmd) >= DMA_MAP_BENCHMARK_V1_SIZE &&
+	       _IOC_SIZE(cmd) < sizeof(struct map_benchmark);
+}
+
 static long map_benchmark_ioctl(struct file *file, unsigned int cmd,
 		unsigned long arg)
 {
 	struct map_benchmark_data *map = file->private_data;
 	void __user *argp = (void __user *)arg;
+	size_t usize = sizeof(map->bparam);
 	u64 old_dma_mask;
 	int ret;
 
-	if (copy_from_user(&map->bparam, argp, sizeof(map->bparam)))
+	/*
+	 * Only exchange the fields old binaries know about, they get the
+	 * default single mapping mode.
+	 */
+	if (map_benchmark_is_v1_cmd(cmd)) {
+		usize = DMA_MAP_BENCHMARK_V1_SIZE;
+		cmd = DMA_MAP_BENCHMARK;
+	}
+
+	memset(&map->bparam, 0, sizeof(map->bparam));
+	if (copy_from_user(&map->bparam, argp, usize))
 		return -EFAULT;
 
 	switch (cmd) {
@@ -233,11 +409,42 @@ static long map_benchmark_ioctl(struct file *file, unsigned int cmd,
 			return -EINVAL;
 		}
 
-		if (map->bparam.granule < 1 || map->bparam.granule > 1024) {
+		if (map->bparam.granule < 1 ||
+		    map->bparam.granule > DMA_MAP_MAX_GRANULE) {
 			pr_err("invalid granule size\n");
 			return -EINVAL;
 		}
 
+		switch (map->bparam.map_mode) {
+		case DMA_MAP_SINGLE_MODE:
+		case DMA_MAP_PAGE_MODE:
+			break;
+		case DMA_MAP_SG_MODE:
+			if (map->bparam.sg_nents < 1 ||
+			    map->bparam.sg_nents > map->bparam.granule) {
+				pr_err("invalid number of scatterlist entries\n");
+				return -EINVAL;
+			}
+			break;
+		case DMA_MAP_BOUNCE_MODE:
+			/* only dma-direct bounces through swiotlb_map() */
+			if (get_dma_ops(map->dev) || use_dma_iommu(map->dev) ||
+			    !is_swiotlb_active(map->dev)) {
+				pr_err("swiotlb is not in use for %s\n",
+					dev_name(map->dev));
+				return -EOPNOTSUPP;
+			}
+			if (map->bparam.granule * PAGE_SIZE >
+			    swiotlb_max_mapping_size(map->dev)) {
+				pr_err("granule too large for swiotlb\n");
+				return -EINVAL;
+			}
+			break;
+		default:
+			pr_err("invalid mapping mode\n");
+			return -EINVAL;
+		}
+
 		switch (map->bparam.dma_dir) {
 		case DMA_MAP_BIDIRECTIONAL:
 			map->dir = DMA_BIDIRECTIONAL;
@@ -280,7 +487,7 @@ static long map_benchmark_ioctl(struct file *file, unsigned int cmd,
 		return -EINVAL;
 	}
 
-	if (copy_to_user(argp, &map->bparam, sizeof(map->bparam)))
+	if (copy_to_user(argp, &map->bparam, usize))
 		return -EFAULT;
 
 	return ret;
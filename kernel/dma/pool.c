@@ -26,6 +26,9 @@ static size_t atomic_pool_size;
 /* Dynamic background expansion when the atomic pool is near capacity */
 static struct work_struct atomic_pool_work;
 
+/* Number of times a pool had no room for an allocation */
+static atomic_t pool_alloc_failures;
+
 static int __init early_coherent_pool(char *p)
 {
 	atomic_pool_size = memparse(p, &p);
@@ -41,6 +44,8 @@ static void __init dma_atomic_pool_debugfs_init(void)
 	debugfs_create_ulong("pool_size_dma", 0400, root, &pool_size_dma);
 	debugfs_create_ulong("pool_size_dma32", 0400, root, &pool_size_dma32);
 	debugfs_create_ulong("pool_size_kernel", 0400, root, &pool_size_kernel);
+	debugfs_create_atomic_t("pool_alloc_failures", 0400, root,
+				&pool_alloc_failures);
 }
 
 static void dma_atomic_pool_size_add(gfp_t gfp, size_t size)
@@ -245,8 +250,16 @@ static struct page *__dma_alloc_from_pool(struct device *dev, size_t size,
 	phys_addr_t phys;
 
 	addr = gen_pool_alloc(pool, size);
-	if (!addr)
+	if (!addr) {
+		/*
+		 * The low-watermark check below only runs on success, so a
+		 * burst that drains the pool in one go would otherwise keep
+		 * failing without ever growing it.
+		 */
+		atomic_inc(&pool_alloc_failures);
+		schedule_work(&atomic_pool_work);
 		return NULL;
+	}
 
 	phys = gen_pool_virt_to_phys(pool, addr);
 	if (phys_addr_ok && !phys_addr_ok(dev, phys, size)) {
@@ -32,12 +32,15 @@
 #include <linux/io.h>
 #include <linux/iommu-helper.h>
 #include <linux/init.h>
+#include <linux/jump_label.h>
 #include <linux/memblock.h>
 #include <linux/mm.h>
+#include <linux/percpu.h>
 #include <linux/pfn.h>
 #include <linux/rculist.h>
 #include <linux/scatterlist.h>
 #include <linux/set_memory.h>
+#include <linux/sizes.h>
 #include <linux/spinlock.h>
 #include <linux/string.h>
 #include <linux/swiotlb.h>
@@ -1341,6 +1344,288 @@ static unsigned long mem_used(struct io_tlb_mem *mem)
 
 #endif /* CONFIG_DEBUG_FS */
 
+/**
+ * swiotlb_free_slots() - return a sequence of slots to its area
+ * @mem:	Memory pool the slots belong to.
+ * @index:	Index of the first slot.
+ * @nslots:	Number of slots.
+ *
+ * This function takes care of locking.
+ */
+static void swiotlb_free_slots(struct io_tlb_pool *mem, int index, int nslots)
+{
+	unsigned long flags;
+	int aindex = index / mem->area_nslabs;
+	struct io_tlb_area *area = &mem->areas[aindex];
+	int count, i;
+
+	/*
+	 * Return the buffer to the free list by setting the corresponding
+	 * entries to indicate the number of contiguous entries available.
+	 * While returning the entries to the free list, we merge the entries
+	 * with slots below and above the pool being returned.
+	 */
+	BUG_ON(aindex >= mem->nareas);
+
+	spin_lock_irqsave(&area->lock, flags);
+	if (index + nslots < ALIGN(index + 1, IO_TLB_SEGSIZE))
+		count = mem->slots[index + nslots].list;
+	else
+		count = 0;
+
+	/*
+	 * Step 1: return the slots to the free list, merging the slots with
+	 * superceeding slots
+	 */
+	for (i = index + nslots - 1; i >= index; i--) {
+		mem->slots[i].list = ++count;
+		mem->slots[i].orig_addr = INVALID_PHYS_ADDR;
+		mem->slots[i].alloc_size = 0;
+		mem->slots[i].pad_slots = 0;
+	}
+
+	/*
+	 * Step 2: merge the returned slots with the preceding slots, if
+	 * available (non zero)
+	 */
+	for (i = index - 1;
+	     io_tlb_offset(i) != IO_TLB_SEGSIZE - 1 && mem->slots[i].list;
+	     i--)
+		mem->slots[i].list = ++count;
+	area->used -= nslots;
+	spin_unlock_irqrestore(&area->lock, flags);
+}
+
+/*
+ * Per-CPU caches of recently released bounce buffers in the default pool.
+ *
+ * When every DMA bounces, as in confidential computing guests, most mappings
+ * are of a handful of sizes and are released shortly after they were made.
+ * Instead of handing such buffers back to their area, keep a few of them per
+ * CPU and per size class, so that the next mapping of the same size can skip
+ * the area lock and the free slot search.
+ *
+ * Cached slots stay allocated as far as the areas are concerned. Only
+ * unaligned streaming mappings from devices without a min_align_mask use the
+ * caches, and every cached buffer starts on a page boundary, so a cached
+ * buffer satisfies any such request of its size class. If the pool runs out
+ * of space, the caches are drained back into the areas before giving up.
+ */
+static const unsigned int swiotlb_pcp_size[] = { SZ_4K, SZ_64K };
+static const unsigned int swiotlb_pcp_depth[] = { 16, 4 };
+
+#define SWIOTLB_PCP_CLASSES	ARRAY_SIZE(swiotlb_pcp_size)
+#define SWIOTLB_PCP_MAX_DEPTH	16
+
+/*
+ * Do not let the caches of all CPUs together pin more than this fraction
+ * of the default pool.
+ */
+#define SWIOTLB_PCP_POOL_SHIFT	3
+
+/**
+ * struct swiotlb_pcp - per-CPU cache of free bounce buffers
+ * @lock:	Protects the cache. Normally only taken by the local CPU.
+ * @nr:		Number of cached buffers in each size class.
+ * @index:	Index of the first slot of each cached buffer.
+ * @hits:	Mappings served from the cache.
+ * @misses:	Eligible mappings which had to search the pool.
+ */
+struct swiotlb_pcp {
+	spinlock_t lock;
+	unsigned int nr[SWIOTLB_PCP_CLASSES];
+	unsigned int index[SWIOTLB_PCP_CLASSES][SWIOTLB_PCP_MAX_DEPTH];
+	unsigned long hits;
+	unsigned long misses;
+};
+
+static DEFINE_PER_CPU(struct swiotlb_pcp, swiotlb_pcp);
+static DEFINE_STATIC_KEY_FALSE(swiotlb_pcp_enabled);
+
+static int swiotlb_pcp_class(unsigned int nslots)
+{
+	int i;
+
+	for (i = 0; i < SWIOTLB_PCP_CLASSES; i++)
+		if (nslots == nr_slots(swiotlb_pcp_size[i]))
+			return i;
+	return -1;
+}
+
+/**
+ * swiotlb_pcp_get() - try to take a bounce buffer from the local cache
+ * @dev:	Device which maps the buffer.
+ * @alloc_size:	Total requested size of the bounce buffer.
+ * @alloc_align_mask:	Required alignment of the allocated buffer.
+ * @retpool:	Used memory pool, updated on success.
+ *
+ * Return: Index of the first allocated slot, or -1 if the request cannot
+ * be served from the cache.
+ */
+static int swiotlb_pcp_get(struct device *dev, size_t alloc_size,
+		unsigned int alloc_align_mask, struct io_tlb_pool **retpool)
+{
+	struct io_tlb_mem *mem = dev->dma_io_tlb_mem;
+	struct io_tlb_pool *pool = &mem->defpool;
+	unsigned long boundary_mask = dma_get_seg_boundary(dev);
+	unsigned int nslots = nr_slots(alloc_size);
+	struct swiotlb_pcp *pcp;
+	unsigned long flags;
+	int class, index = -1;
+	unsigned int i;
+
+	if (!static_branch_unlikely(&swiotlb_pcp_enabled) ||
+	    mem != &io_tlb_default_mem || alloc_align_mask ||
+	    dma_get_min_align_mask(dev))
+		return -1;
+
+	class = swiotlb_pcp_class(nslots);
+	if (class < 0)
+		return -1;
+
+	/*
+	 * The lock protects the cache, so it does not matter if we migrate
+	 * and end up using another CPU's cache; the local one is just the
+	 * likely uncontended choice. spinlock_t sleeps on PREEMPT_RT, so it
+	 * must not be taken with interrupts already disabled.
+	 */
+	pcp = raw_cpu_ptr(&swiotlb_pcp);
+	spin_lock_irqsave(&pcp->lock, flags);
+	if (pcp->nr[class]) {
+		i = pcp->index[class][pcp->nr[class] - 1];
+		if (!iommu_is_span_boundary(i, nslots,
+				nr_slots(phys_to_dma_unencrypted(dev,
+						pool->start) & boundary_mask),
+				get_max_slots(boundary_mask))) {
+			pcp->nr[class]--;
+			index = i;
+		}
+	}
+	if (index >= 0)
+		pcp->hits++;
+	else
+		pcp->misses++;
+	spin_unlock_irqrestore(&pcp->lock, flags);
+
+	if (index < 0)
+		return -1;
+
+	for (i = 0; i < nslots; i++)
+		pool->slots[index + i].alloc_size =
+			alloc_size - (i << IO_TLB_SHIFT);
+	inc_used_and_hiwater(mem, nslots);
+
+#ifdef CONFIG_SWIOTLB_DYNAMIC
+	/* See swiotlb_find_slots() */
+	WRITE_ONCE(dev->dma_uses_io_tlb, true);
+	smp_mb();
+#endif
+
+	*retpool = pool;
+	return index;
+}
+
+/**
+ * swiotlb_pcp_put() - try to keep a released bounce buffer in the local cache
+ * @dev:	Device which mapped the buffer.
+ * @mem:	Memory pool the buffer belongs to.
+ * @index:	Index of the first slot.
+ * @nslots:	Number of slots.
+ *
+ * Return: %true if the buffer was cached.
+ */
+static bool swiotlb_pcp_put(struct device *dev, struct io_tlb_pool *mem,
+		int index, int nslots)
+{
+	struct swiotlb_pcp *pcp;
+	unsigned long flags;
+	bool cached = false;
+	int class, i;
+
+	if (!static_branch_unlikely(&swiotlb_pcp_enabled) ||
+	    mem != &io_tlb_default_mem.defpool ||
+	    dma_get_min_align_mask(dev) ||
+	    !PAGE_ALIGNED(slot_addr(mem->start, index)))
+		return false;
+
+	class = swiotlb_pcp_class(nslots);
+	if (class < 0)
+		return false;
+
+	for (i = index; i < index + nslots; i++) {
+		mem->slots[i].orig_addr = INVALID_PHYS_ADDR;
+		mem->slots[i].alloc_size = 0;
+		mem->slots[i].pad_slots = 0;
+	}
+
+	/* See swiotlb_pcp_get() */
+	pcp = raw_cpu_ptr(&swiotlb_pcp);
+	spin_lock_irqsave(&pcp->lock, flags);
+	if (pcp->nr[class] < swiotlb_pcp_depth[class]) {
+		pcp->index[class][pcp->nr[class]++] = index;
+		cached = true;
+	}
+	spin_unlock_irqrestore(&pcp->lock, flags);
+
+	return cached;
+}
+
+/**
+ * swiotlb_pcp_drain() - return all cached bounce buffers to their areas
+ *
+ * Return: %true if any buffer was returned.
+ */
+static bool swiotlb_pcp_drain(void)
+{
+	struct io_tlb_pool *mem = &io_tlb_default_mem.defpool;
+	bool drained = false;
+	unsigned long flags;
+	int cpu, class;
+
+	if (!static_branch_unlikely(&swiotlb_pcp_enabled))
+		return false;
+
+	for_each_possible_cpu(cpu) {
+		struct swiotlb_pcp *pcp = per_cpu_ptr(&swiotlb_pcp, cpu);
+
+		spin_lock_irqsave(&pcp->lock, flags);
+		for (class = 0; class < SWIOTLB_PCP_CLASSES; class++) {
+			while (pcp->nr[class]) {
+				swiotlb_free_slots(mem,
+					pcp->index[class][--pcp->nr[class]],
+					nr_slots(swiotlb_pcp_size[class]));
+				drained = true;
+			}
+		}
+		spin_unlock_irqrestore(&pcp->lock, flags);
+	}
+
+	return drained;
+}
+
+static int __init swiotlb_pcp_init(void)
+{
+	unsigned long pinned = 0;
+	int cpu, class;
+
+	for (class = 0; class < SWIOTLB_PCP_CLASSES; class++)
+		pinned += swiotlb_pcp_depth[class] *
+			  nr_slots(swiotlb_pcp_size[class]);
+	pinned *= num_possible_cpus();
+
+	/* Not worth it, or too costly, for a small or missing default pool. */
+	if (!io_tlb_default_mem.nslabs ||
+	    pinned > io_tlb_default_mem.defpool.nslabs >> SWIOTLB_PCP_POOL_SHIFT)
+		return 0;
+
+	for_each_possible_cpu(cpu)
+		spin_lock_init(&per_cpu_ptr(&swiotlb_pcp, cpu)->lock);
+	static_branch_enable(&swiotlb_pcp_enabled);
+	return 0;
+}
+/* After any IOMMU driver had a chance to release the default pool. */
+late_initcall(swiotlb_pcp_init);
+
 /**
  * swiotlb_tbl_map_single() - bounce buffer map a single contiguous physical area
  * @dev:		Device which maps the buffer.
@@ -1400,7 +1685,13 @@ phys_addr_t swiotlb_tbl_map_single(struct device *dev, phys_addr_t orig_addr,
 
 	offset = swiotlb_align_offset(dev, alloc_align_mask, orig_addr);
 	size = ALIGN(mapping_size + offset, alloc_align_mask + 1);
-	index = swiotlb_find_slots(dev, orig_addr, size, alloc_align_mask, &pool);
+	index = swiotlb_pcp_get(dev, size, alloc_align_mask, &pool);
+	if (index == -1)
+		index = swiotlb_find_slots(dev, orig_addr, size,
+					   alloc_align_mask, &pool);
+	if (index == -1 && swiotlb_pcp_drain())
+		index = swiotlb_find_slots(dev, orig_addr, size,
+					   alloc_align_mask, &pool);
 	if (index == -1) {
 		if (!(attrs & DMA_ATTR_NO_WARN))
 			dev_warn_ratelimited(dev,
@@ -1443,53 +1734,15 @@ phys_addr_t swiotlb_tbl_map_single(struct device *dev, phys_addr_t orig_addr,
 static void swiotlb_release_slots(struct device *dev, phys_addr_t tlb_addr,
 				  struct io_tlb_pool *mem)
 {
-	unsigned long flags;
 	unsigned int offset = swiotlb_align_offset(dev, 0, tlb_addr);
-	int index, nslots, aindex;
-	struct io_tlb_area *area;
-	int count, i;
+	int index, nslots;
 
 	index = (tlb_addr - offset - mem->start) >> IO_TLB_SHIFT;
 	index -= mem->slots[index].pad_slots;
 	nslots = nr_slots(mem->slots[index].alloc_size + offset);
-	aindex = index / mem->area_nslabs;
-	area = &mem->areas[aindex];
 
-	/*
-	 * Return the buffer to the free list by setting the corresponding
-	 * entries to indicate the number of contiguous entries available.
-	 * While returning the entries to the free list, we merge the entries
-	 * with slots below and above the pool being returned.
-	 */
-	BUG_ON(aindex >= mem->nareas);
-
-	spin_lock_irqsave(&area->lock, flags);
-	if (index + nslots < ALIGN(index + 1, IO_TLB_SEGSIZE))
-		count = mem->slots[index + nslots].list;
-	else
-		count = 0;
-
-	/*
-	 * Step 1: return the slots to the free list, merging the slots with
-	 * superceeding slots
-	 */
-	for (i = index + nslots - 1; i >= index; i--) {
-		mem->slots[i].list = ++count;
-		mem->slots[i].orig_addr = INVALID_PHYS_ADDR;
-		mem->slots[i].alloc_size = 0;
-		mem->slots[i].pad_slots = 0;
-	}
-
-	/*
-	 * Step 2: merge the returned slots with the preceding slots, if
-	 * available (non zero)
-	 */
-	for (i = index - 1;
-	     io_tlb_offset(i) != IO_TLB_SEGSIZE - 1 && mem->slots[i].list;
-	     i--)
-		mem->slots[i].list = ++count;
-	area->used -= nslots;
-	spin_unlock_irqrestore(&area->lock, flags);
+	if (!swiotlb_pcp_put(dev, mem, index, nslots))
+		swiotlb_free_slots(mem, index, nslots);
 
 	dec_used(dev->dma_io_tlb_mem, nslots);
 }
@@ -1729,9 +1982,48 @@ static void swiotlb_create_debugfs_files(struct io_tlb_mem *mem,
 #endif
 }
 
+static u64 swiotlb_pcp_sum(bool hits)
+{
+	struct swiotlb_pcp *pcp;
+	u64 sum = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		pcp = per_cpu_ptr(&swiotlb_pcp, cpu);
+		sum += hits ? data_race(pcp->hits) : data_race(pcp->misses);
+	}
+	return sum;
+}
+
+static int io_tlb_pcp_hits_get(void *data, u64 *val)
+{
+	*val = swiotlb_pcp_sum(true);
+	return 0;
+}
+
+static int io_tlb_pcp_misses_get(void *data, u64 *val)
+{
+	*val = swiotlb_pcp_sum(false);
+	return 0;
+}
+
+DEFINE_DEBUGFS_ATTRIBUTE(fops_io_tlb_pcp_hits, io_tlb_pcp_hits_get, NULL,
+			 "%llu\n");
+DEFINE_DEBUGFS_ATTRIBUTE(fops_io_tlb_pcp_misses, io_tlb_pcp_misses_get, NULL,
+			 "%llu\n");
+
 static int __init swiotlb_create_default_debugfs(void)
 {
 	swiotlb_create_debugfs_files(&io_tlb_default_mem, "swiotlb");
+	/* swiotlb_pcp_init() runs before us in the same initcall level */
+	if (static_branch_unlikely(&swiotlb_pcp_enabled)) {
+		debugfs_create_file("io_tlb_pcp_hits", 0400,
+				    io_tlb_default_mem.debugfs, NULL,
+				    &fops_io_tlb_pcp_hits);
+		debugfs_create_file("io_tlb_pcp_misses", 0400,
+				    io_tlb_default_mem.debugfs, NULL,
+				    &fops_io_tlb_pcp_misses);
+	}
 	return 0;
 }
 
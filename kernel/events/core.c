@@ -9842,6 +9842,25 @@ static inline void perf_event_free_bpf_handler(struct perf_event *event)
 }
 #endif
 
+/*
+ * Freeze the ring buffer @event writes to, leaving the records that led up
+ * to the overflow in place for user space to read from the mmap()ed buffer.
+ * Output is resumed with PERF_EVENT_IOC_PAUSE_OUTPUT.
+ */
+static void perf_event_pause_output(struct perf_event *event)
+{
+	struct perf_buffer *rb;
+
+	if (event->parent)
+		event = event->parent;
+
+	rcu_read_lock();
+	rb = rcu_dereference(event->rb);
+	if (rb)
+		rb_toggle_paused(rb, true);
+	rcu_read_unlock();
+}
+
 /*
  * Generic event overflow handling, sampling.
  */
@@ -9925,6 +9944,10 @@ static int __perf_event_overflow(struct perf_event *event,
 
 	READ_ONCE(event->overflow_handler)(event, data, regs);
 
+	/* The triggering sample is the last record before the freeze. */
+	if (event->attr.pause_output)
+		perf_event_pause_output(event);
+
 	if (*perf_event_fasync(event) && event->pending_kill) {
 		event->pending_wakeup = 1;
 		irq_work_queue(&event->pending_irq);
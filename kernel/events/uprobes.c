@@ -1803,13 +1803,18 @@ static unsigned long xol_get_slot_nr(struct xol_area *area)
 {
 	unsigned long slot_nr;
 
-	slot_nr = find_first_zero_bit(area->bitmap, UINSNS_PER_PAGE);
-	if (slot_nr < UINSNS_PER_PAGE) {
+	/*
+	 * Losing the race for a free slot to another thread must not make
+	 * us sleep in xol_get_insn_slot() while other slots are still free,
+	 * so look for the next one instead.
+	 */
+	for (;;) {
+		slot_nr = find_first_zero_bit(area->bitmap, UINSNS_PER_PAGE);
+		if (slot_nr >= UINSNS_PER_PAGE)
+			return UINSNS_PER_PAGE;
 		if (!test_and_set_bit(slot_nr, area->bitmap))
 			return slot_nr;
 	}
-
-	return UINSNS_PER_PAGE;
 }
 
 /*
@@ -354,6 +354,47 @@ SYSCALL_DEFINE4(futex_wake,
 	return futex_wake(uaddr, FLAGS_STRICT | flags, nr, mask);
 }
 
+/*
+ * sys_futex_wakev - Wake waiters on a list of futexes
+ * @waiters:	List of futexes to wake
+ * @nr_futexes:	Length of @waiters
+ * @flags:	unused
+ *
+ * For each entry, wake up to @waiters[i].val waiters on @waiters[i].uaddr.
+ * Equivalent to a futex_wake() per entry with a match-any mask, but every
+ * hash bucket is locked once and all wakeups are issued in one go after
+ * dropping the locks.
+ *
+ * Returns the total number of woken waiters.
+ */
+SYSCALL_DEFINE3(futex_wakev,
+		struct futex_waitv __user *, waiters,
+		unsigned int, nr_futexes,
+		unsigned int, flags)
+{
+	struct futex_vector *futexv;
+	int ret;
+
+	/* This syscall supports no flags for now */
+	if (flags)
+		return -EINVAL;
+
+	if (!nr_futexes || nr_futexes > FUTEX_WAITV_MAX || !waiters)
+		return -EINVAL;
+
+	futexv = kcalloc(nr_futexes, sizeof(*futexv), GFP_KERNEL);
+	if (!futexv)
+		return -ENOMEM;
+
+	ret = futex_parse_waitv(futexv, waiters, nr_futexes, futex_wake_mark,
+				NULL);
+	if (!ret)
+		ret = futex_wake_multiple(futexv, nr_futexes);
+
+	kfree(futexv);
+	return ret;
+}
+
 /*
  * sys_futex_wait - Wait on a futex
  * @uaddr:	Address of the futex to wait on
@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <linux/plist.h>
+#include <linux/slab.h>
+#include <linux/sort.h>
 #include <linux/sched/task.h>
 #include <linux/sched/signal.h>
 #include <linux/freezer.h>
@@ -200,6 +202,110 @@ int futex_wake(u32 __user *uaddr, unsigned int flags, int nr_wake, u32 bitset)
 	return ret;
 }
 
+struct futex_wake_ent {
+	struct futex_hash_bucket	*hb;
+	struct futex_vector		*v;
+};
+
+static int futex_wake_ent_cmp(const void *a, const void *b)
+{
+	const struct futex_wake_ent *ea = a, *eb = b;
+
+	if (ea->hb == eb->hb)
+		return 0;
+	return ea->hb < eb->hb ? -1 : 1;
+}
+
+/* Wake up to @nr_wake waiters on @key. Must be called with @hb->lock held. */
+static int __futex_wake_key(struct futex_hash_bucket *hb, union futex_key *key,
+			    int nr_wake, struct wake_q_head *wake_q)
+{
+	struct futex_q *this, *next;
+	int ret = 0;
+
+	if (!nr_wake)
+		return 0;
+
+	plist_for_each_entry_safe(this, next, &hb->chain, list) {
+		if (!futex_match(&this->key, key))
+			continue;
+
+		/* PI futexes have to be woken through FUTEX_UNLOCK_PI. */
+		if (this->pi_state || this->rt_waiter)
+			return ret;
+
+		this->wake(wake_q, this);
+		if (++ret >= nr_wake)
+			break;
+	}
+
+	return ret;
+}
+
+/**
+ * futex_wake_multiple - Wake waiters on a list of futexes
+ * @vs:		The futex list to wake, w.val is the number of waiters to wake
+ * @count:	The size of the list
+ *
+ * The keys are resolved first, then sorted by hash bucket so that every
+ * bucket lock is taken once no matter how many of the futexes hash to it.
+ * All woken tasks are collected on a single wake_q which is processed after
+ * the last bucket lock has been dropped.
+ *
+ * A futex with PI waiters is left alone, as with futex_wake().
+ *
+ * Return: The total number of woken waiters, or an error code if resolving
+ * a futex key failed. Nothing is woken in that case.
+ */
+int futex_wake_multiple(struct futex_vector *vs, unsigned int count)
+{
+	struct futex_wake_ent *ents;
+	DEFINE_WAKE_Q(wake_q);
+	unsigned int i, j;
+	int ret = 0;
+
+	ents = kcalloc(count, sizeof(*ents), GFP_KERNEL);
+	if (!ents)
+		return -ENOMEM;
+
+	for (i = 0; i < count; i++) {
+		struct futex_vector *v = &vs[i];
+
+		ret = get_futex_key(u64_to_user_ptr(v->w.uaddr), v->w.flags,
+				    &v->q.key, FUTEX_READ);
+		if (unlikely(ret))
+			goto out;
+
+		ents[i].hb = futex_hash(&v->q.key);
+		ents[i].v = v;
+	}
+
+	sort(ents, count, sizeof(*ents), futex_wake_ent_cmp, NULL);
+
+	for (i = 0; i < count; i = j) {
+		struct futex_hash_bucket *hb = ents[i].hb;
+
+		for (j = i + 1; j < count && ents[j].hb == hb; j++)
+			;
+
+		/* Make sure we really have tasks to wakeup */
+		if (!futex_hb_waiters_pending(hb))
+			continue;
+
+		spin_lock(&hb->lock);
+		for (; i < j; i++)
+			ret += __futex_wake_key(hb, &ents[i].v->q.key,
+						min_t(u64, ents[i].v->w.val, INT_MAX),
+						&wake_q);
+		spin_unlock(&hb->lock);
+	}
+
+	wake_up_q(&wake_q);
+out:
+	kfree(ents);
+	return ret;
+}
+
 static int futex_atomic_op_inuser(unsigned int encoded_op, u32 __user *uaddr)
 {
 	unsigned int op =	  (encoded_op & 0x70000000) >> 28;
@@ -7,6 +7,8 @@
 #include <linux/percpu.h>
 #include <linux/cpu.h>
 #include <linux/irq.h>
+#include <linux/jiffies.h>
+#include <linux/kernel_stat.h>
 
 struct cpumap {
 	unsigned int		available;
@@ -29,6 +31,7 @@ struct irq_matrix {
 	unsigned int		systembits_inalloc;
 	unsigned int		total_allocated;
 	unsigned int		online_maps;
+	irq_matrix_cost_fn	cost;
 	struct cpumap __percpu	*maps;
 	unsigned long		*system_map;
 	unsigned long		scratch_map[];
@@ -131,11 +134,18 @@ static unsigned int matrix_alloc_area(struct irq_matrix *m, struct cpumap *cm,
 	return area;
 }
 
+/*
+ * With a cost function installed, CPUs whose number of available vectors
+ * is at most this far below the best one compete on cost instead.
+ */
+#define MATRIX_COST_SLACK	8
+
 /* Find the best CPU which has the lowest vector allocation count */
 static unsigned int matrix_find_best_cpu(struct irq_matrix *m,
 					const struct cpumask *msk)
 {
 	unsigned int cpu, best_cpu, maxavl = 0;
+	unsigned long cost, mincost = ULONG_MAX;
 	struct cpumap *cm;
 
 	best_cpu = UINT_MAX;
@@ -149,6 +159,24 @@ static unsigned int matrix_find_best_cpu(struct irq_matrix *m,
 		best_cpu = cpu;
 		maxavl = cm->available;
 	}
+
+	if (!m->cost || best_cpu == UINT_MAX)
+		return best_cpu;
+
+	/* Among the CPUs with about as many free vectors, pick the cheapest */
+	for_each_cpu(cpu, msk) {
+		cm = per_cpu_ptr(m->maps, cpu);
+
+		if (!cm->online || !cm->available ||
+		    cm->available + MATRIX_COST_SLACK < maxavl)
+			continue;
+
+		cost = m->cost(cpu);
+		if (cost < mincost) {
+			best_cpu = cpu;
+			mincost = cost;
+		}
+	}
 	return best_cpu;
 }
 
@@ -173,6 +201,52 @@ static unsigned int matrix_find_best_cpu_managed(struct irq_matrix *m,
 	return best_cpu;
 }
 
+/**
+ * irq_matrix_set_cost - Install a cost function for CPU selection
+ * @m:		Matrix pointer
+ * @cost:	Function returning the cost of placing one more interrupt on
+ *		a CPU, or NULL to select by available vectors only
+ *
+ * Non-managed allocations pick the CPU with the lowest cost among the ones
+ * which have nearly as many vectors available as the best one. @cost is
+ * invoked with the lock protecting the matrix held.
+ */
+void irq_matrix_set_cost(struct irq_matrix *m, irq_matrix_cost_fn cost)
+{
+	m->cost = cost;
+}
+
+struct irq_rate_sample {
+	unsigned long	irqs;
+	unsigned long	stamp;
+	unsigned long	rate;
+};
+
+static DEFINE_PER_CPU(struct irq_rate_sample, irq_rate_samples);
+
+/**
+ * irq_matrix_irq_rate - Interrupt rate cost function
+ * @cpu:	The CPU to evaluate
+ *
+ * Returns the number of hard interrupts per second @cpu handled over the
+ * last sampling period of at least one second. Sampled lazily, so the
+ * matrix lock must be held to serialize the updates.
+ */
+unsigned long irq_matrix_irq_rate(unsigned int cpu)
+{
+	struct irq_rate_sample *s = per_cpu_ptr(&irq_rate_samples, cpu);
+	unsigned long now = jiffies, elapsed = now - s->stamp;
+	unsigned long irqs;
+
+	if (elapsed >= HZ) {
+		irqs = kstat_cpu_irqs_sum(cpu);
+		s->rate = (irqs - s->irqs) / (elapsed / HZ);
+		s->irqs = irqs;
+		s->stamp = now;
+	}
+	return s->rate;
+}
+
 /**
  * irq_matrix_assign_system - Assign system wide entry in the matrix
  * @m:		Matrix pointer
@@ -215,7 +215,6 @@ static int klp_check_stack_func(struct klp_func *func, unsigned long *entries,
 				unsigned int nr_entries)
 {
 	unsigned long func_addr, func_size, address;
-	struct klp_ops *ops;
 	int i;
 
 	if (klp_target_state == KLP_TRANSITION_UNPATCHED) {
@@ -229,10 +228,14 @@ static int klp_check_stack_func(struct klp_func *func, unsigned long *entries,
 		/*
 		 * Check for the to-be-patched function
 		 * (the previous func).
+		 *
+		 * The func being patched in sits on top of its
+		 * ops->func_stack, so its predecessor is the list head.
+		 * Then it's the only entry exactly when its successor is
+		 * the list head too. This spares a klp_find_ops() walk
+		 * for every function of every task checked.
 		 */
-		ops = klp_find_ops(func->old_func);
-
-		if (list_is_singular(&ops->func_stack)) {
+		if (func->stack_node.next == func->stack_node.prev) {
 			/* original function */
 			func_addr = (unsigned long)func->old_func;
 			func_size = func->old_size;
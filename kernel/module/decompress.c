@@ -204,6 +204,64 @@ static ssize_t module_xz_decompress(struct load_info *info,
 #define MODULE_COMPRESSION	zstd
 #define MODULE_DECOMPRESS_FN	module_zstd_decompress
 
+/*
+ * When the frame records its decompressed size, which is the default for
+ * the zstd tool, we can allocate every page up front, map them once and
+ * decompress the whole module in a single call straight into its final
+ * buffer. This avoids both the streaming window copy and the per-page
+ * decompression loop, and needs a much smaller workspace.
+ */
+static ssize_t module_zstd_decompress_oneshot(struct load_info *info,
+					      const void *buf, size_t size,
+					      unsigned long long content_size)
+{
+	unsigned int n_pages = DIV_ROUND_UP(content_size, PAGE_SIZE);
+	size_t wksp_size;
+	void *wksp = NULL;
+	zstd_dctx *dctx;
+	size_t ret;
+	int retval;
+
+	while (info->used_pages < n_pages) {
+		struct page *page = module_get_next_page(info);
+
+		if (IS_ERR(page))
+			return PTR_ERR(page);
+	}
+
+	info->hdr = vmap(info->pages, info->used_pages, VM_MAP, PAGE_KERNEL);
+	if (!info->hdr)
+		return -ENOMEM;
+
+	wksp_size = zstd_dctx_workspace_bound();
+	wksp = kvmalloc(wksp_size, GFP_KERNEL);
+	if (!wksp) {
+		retval = -ENOMEM;
+		goto out;
+	}
+
+	dctx = zstd_init_dctx(wksp, wksp_size);
+	if (!dctx) {
+		pr_err("Can't initialize ZSTD context\n");
+		retval = -ENOMEM;
+		goto out;
+	}
+
+	ret = zstd_decompress_dctx(dctx, info->hdr, content_size, buf, size);
+	retval = zstd_get_error_code(ret);
+	if (retval) {
+		pr_err("ZSTD-decompression failed with status %d\n", retval);
+		retval = -EINVAL;
+		goto out;
+	}
+
+	retval = ret;
+
+ out:
+	kvfree(wksp);
+	return retval;
+}
+
 static ssize_t module_zstd_decompress(struct load_info *info,
 				    const void *buf, size_t size)
 {
@@ -240,6 +298,12 @@ static ssize_t module_zstd_decompress(struct load_info *info,
 		goto out;
 	}
 
+	if (header.frameContentSize &&
+	    header.frameContentSize != ZSTD_CONTENTSIZE_UNKNOWN &&
+	    header.frameContentSize <= INT_MAX)
+		return module_zstd_decompress_oneshot(info, buf, size,
+						      header.frameContentSize);
+
 	wksp_size = zstd_dstream_workspace_bound(header.windowSize);
 	wksp = kvmalloc(wksp_size, GFP_KERNEL);
 	if (!wksp) {
@@ -314,7 +378,10 @@ int module_decompress(struct load_info *info, const void *buf, size_t size)
 		goto err;
 	}
 
-	info->hdr = vmap(info->pages, info->used_pages, VM_MAP, PAGE_KERNEL);
+	/* The decompressor may already have mapped the pages itself. */
+	if (!info->hdr)
+		info->hdr = vmap(info->pages, info->used_pages, VM_MAP,
+				 PAGE_KERNEL);
 	if (!info->hdr) {
 		error = -ENOMEM;
 		goto err;
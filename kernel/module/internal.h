@@ -8,6 +8,7 @@
 
 #include <linux/elf.h>
 #include <linux/compiler.h>
+#include <linux/ktime.h>
 #include <linux/module.h>
 #include <linux/mutex.h>
 #include <linux/rculist.h>
@@ -198,15 +199,25 @@ extern struct dentry *mod_debugfs_root;
 
 #define mod_stat_add_long(count, var) atomic_long_add(count, var)
 #define mod_stat_inc(name) atomic_inc(name)
+#define mod_stat_add_time(start, var) atomic_long_add(ktime_get_ns() - (start), var)
+
+static inline u64 mod_stat_clock(void)
+{
+	return ktime_get_ns();
+}
 
 extern atomic_long_t total_mod_size;
 extern atomic_long_t total_text_size;
 extern atomic_long_t invalid_kread_bytes;
 extern atomic_long_t invalid_decompress_bytes;
+extern atomic_long_t total_decompress_ns;
+extern atomic_long_t total_load_ns;
 
 extern atomic_t modcount;
 extern atomic_t failed_kreads;
 extern atomic_t failed_decompress;
+extern atomic_t decompressed_mods;
+extern atomic_t timed_loads;
 struct mod_fail_load {
 	struct list_head list;
 	char name[MODULE_NAME_LEN];
@@ -222,6 +233,12 @@ void mod_stat_bump_becoming(struct load_info *info, int flags);
 
 #define mod_stat_add_long(name, var)
 #define mod_stat_inc(name)
+#define mod_stat_add_time(start, var) do { (void)(start); } while (0)
+
+static inline u64 mod_stat_clock(void)
+{
+	return 0;
+}
 
 static inline int try_add_failed_module(const char *name,
 					enum fail_dup_mod_reason reason)
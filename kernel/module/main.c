@@ -3541,7 +3541,8 @@ static int init_module_from_file(struct file *f, const char __user * uargs, int
 {
 	struct load_info info = { };
 	void *buf = NULL;
-	int len;
+	u64 start;
+	int len, err;
 
 	len = kernel_read_file(f, 0, &buf, INT_MAX, NULL, READING_MODULE);
 	if (len < 0) {
@@ -3550,7 +3551,10 @@ static int init_module_from_file(struct file *f, const char __user * uargs, int
 	}
 
 	if (flags & MODULE_INIT_COMPRESSED_FILE) {
-		int err = module_decompress(&info, buf, len);
+		start = mod_stat_clock();
+		err = module_decompress(&info, buf, len);
+		mod_stat_add_time(start, &total_decompress_ns);
+		mod_stat_inc(&decompressed_mods);
 		vfree(buf); /* compressed data is no longer needed */
 		if (err) {
 			mod_stat_inc(&failed_decompress);
@@ -3562,7 +3566,14 @@ static int init_module_from_file(struct file *f, const char __user * uargs, int
 		info.len = len;
 	}
 
-	return load_module(&info, uargs, flags);
+	start = mod_stat_clock();
+	err = load_module(&info, uargs, flags);
+	if (!err) {
+		mod_stat_add_time(start, &total_load_ns);
+		mod_stat_inc(&timed_loads);
+	}
+
+	return err;
 }
 
 static int idempotent_init_module(struct file *f, const char __user * uargs, int flags)
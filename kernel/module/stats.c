@@ -172,11 +172,22 @@ static LIST_HEAD(dup_failed_modules);
  *     the size of the module. Additionally if you used module decompression
  *     the size of the compressed module is also added to this counter.
  *
+ *   * total_decompress_ns: total time in nanoseconds spent decompressing
+ *     modules, successful or not.
+ *   * total_load_ns: total time in nanoseconds spent in load_module() for
+ *     modules which were successfully loaded through finit_module(),
+ *     including the time spent in their initialization routines but not
+ *     their decompression.
+ *
  *  * modcount: how many modules we've loaded in our kernel life time
  *  * failed_kreads: how many modules failed due to failed kernel_read_file_from_fd()
  *  * failed_decompress: how many failed module decompression attempts we've had.
  *    These really should not happen unless your compression / decompression
  *    might be broken.
+ *  * decompressed_mods: how many modules we've tried to decompress. Together
+ *    with total_decompress_ns this gives the average decompression time.
+ *  * timed_loads: how many successful loads were accounted in total_load_ns.
+ *    Together with it this gives the average load time.
  *  * failed_becoming: how many modules failed after we kernel_read_file_from_fd()
  *    it and before we allocate memory for it with layout_and_allocate(). This
  *    counter is never incremented if you manage to validate the module and
@@ -199,9 +210,13 @@ atomic_long_t invalid_kread_bytes;
 atomic_long_t invalid_decompress_bytes;
 static atomic_long_t invalid_becoming_bytes;
 static atomic_long_t invalid_mod_bytes;
+atomic_long_t total_decompress_ns;
+atomic_long_t total_load_ns;
 atomic_t modcount;
 atomic_t failed_kreads;
 atomic_t failed_decompress;
+atomic_t decompressed_mods;
+atomic_t timed_loads;
 static atomic_t failed_becoming;
 static atomic_t failed_load_modules;
 
@@ -262,12 +277,12 @@ int try_add_failed_module(const char *name, enum fail_dup_mod_reason reason)
 }
 
 /*
- * At 64 bytes per module and assuming a 1024 bytes preamble we can fit the
- * 112 module prints within 8k.
+ * At 64 bytes per module and assuming a 1536 bytes preamble we can fit the
+ * 112 module prints within 8.5k.
  *
- * 1024 + (64*112) = 8k
+ * 1536 + (64*112) = 8704
  */
-#define MAX_PREAMBLE 1024
+#define MAX_PREAMBLE 1536
 #define MAX_FAILED_MOD_PRINT 112
 #define MAX_BYTES_PER_MOD 64
 static ssize_t read_file_mod_stats(struct file *file, char __user *user_buf,
@@ -277,15 +292,19 @@ static ssize_t read_file_mod_stats(struct file *file, char __user *user_buf,
 	unsigned int len, size, count_failed = 0;
 	char *buf;
 	int ret;
-	u32 live_mod_count, fkreads, fdecompress, fbecoming, floads;
+	u32 live_mod_count, fkreads, fdecompress, fbecoming, floads, ndecompress;
+	u32 nloads;
 	unsigned long total_size, text_size, ikread_bytes, ibecoming_bytes,
 		idecompress_bytes, imod_bytes, total_virtual_lost;
+	unsigned long decompress_ns, load_ns;
 
 	live_mod_count = atomic_read(&modcount);
 	fkreads = atomic_read(&failed_kreads);
 	fdecompress = atomic_read(&failed_decompress);
 	fbecoming = atomic_read(&failed_becoming);
 	floads = atomic_read(&failed_load_modules);
+	ndecompress = atomic_read(&decompressed_mods);
+	nloads = atomic_read(&timed_loads);
 
 	total_size = atomic_long_read(&total_mod_size);
 	text_size = atomic_long_read(&total_text_size);
@@ -293,6 +312,8 @@ static ssize_t read_file_mod_stats(struct file *file, char __user *user_buf,
 	idecompress_bytes = atomic_long_read(&invalid_decompress_bytes);
 	ibecoming_bytes = atomic_long_read(&invalid_becoming_bytes);
 	imod_bytes = atomic_long_read(&invalid_mod_bytes);
+	decompress_ns = atomic_long_read(&total_decompress_ns);
+	load_ns = atomic_long_read(&total_load_ns);
 
 	total_virtual_lost = ikread_bytes + idecompress_bytes + ibecoming_bytes + imod_bytes;
 
@@ -327,6 +348,11 @@ static ssize_t read_file_mod_stats(struct file *file, char __user *user_buf,
 
 	len += scnprintf(buf + len, size - len, "%25s\t%lu\n", "Virtual mem wasted bytes", total_virtual_lost);
 
+	len += scnprintf(buf + len, size - len, "%25s\t%lu\n", "Total decompress time ns",
+			 decompress_ns);
+
+	len += scnprintf(buf + len, size - len, "%25s\t%lu\n", "Total load time ns", load_ns);
+
 	if (live_mod_count && total_size) {
 		len += scnprintf(buf + len, size - len, "%25s\t%lu\n", "Average mod size",
 				 DIV_ROUND_UP(total_size, live_mod_count));
@@ -337,6 +363,16 @@ static ssize_t read_file_mod_stats(struct file *file, char __user *user_buf,
 				 DIV_ROUND_UP(text_size, live_mod_count));
 	}
 
+	if (ndecompress && decompress_ns) {
+		len += scnprintf(buf + len, size - len, "%25s\t%lu\n", "Avg decompress time ns",
+				 DIV_ROUND_UP(decompress_ns, ndecompress));
+	}
+
+	if (nloads && load_ns) {
+		len += scnprintf(buf + len, size - len, "%25s\t%lu\n", "Average load time ns",
+				 DIV_ROUND_UP(load_ns, nloads));
+	}
+
 	/*
 	 * We use WARN_ON_ONCE() for the counters to ensure we always have parity
 	 * for keeping tabs on a type of failure with one type of byte counter.
@@ -416,12 +452,16 @@ static int __init module_stats_init(void)
 	mod_debug_add_ulong(invalid_decompress_bytes);
 	mod_debug_add_ulong(invalid_becoming_bytes);
 	mod_debug_add_ulong(invalid_mod_bytes);
+	mod_debug_add_ulong(total_decompress_ns);
+	mod_debug_add_ulong(total_load_ns);
 
 	mod_debug_add_atomic(modcount);
 	mod_debug_add_atomic(failed_kreads);
 	mod_debug_add_atomic(failed_decompress);
 	mod_debug_add_atomic(failed_becoming);
 	mod_debug_add_atomic(failed_load_modules);
+	mod_debug_add_atomic(decompressed_mods);
+	mod_debug_add_atomic(timed_loads);
 
 	debugfs_create_file("stats", 0400, mod_debugfs_root, mod_debugfs_root, &fops_mod_stats);
 
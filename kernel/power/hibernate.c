@@ -732,6 +732,7 @@ static int load_image_and_restore(void)
 
 #define COMPRESSION_ALGO_LZO "lzo"
 #define COMPRESSION_ALGO_LZ4 "lz4"
+#define COMPRESSION_ALGO_ZSTD "zstd"
 
 /**
  * hibernate - Carry out system hibernation, including saving the image.
@@ -799,13 +800,15 @@ int hibernate(void)
 
 			/*
 			 * By default, LZO compression is enabled. Use SF_COMPRESSION_ALG_LZ4
-			 * to override this behaviour and use LZ4.
+			 * or SF_COMPRESSION_ALG_ZSTD to override this behaviour.
 			 *
 			 * Refer kernel/power/power.h for more details
 			 */
 
 			if (!strcmp(hib_comp_algo, COMPRESSION_ALGO_LZ4))
 				flags |= SF_COMPRESSION_ALG_LZ4;
+			else if (!strcmp(hib_comp_algo, COMPRESSION_ALGO_ZSTD))
+				flags |= SF_COMPRESSION_ALG_ZSTD;
 			else
 				flags |= SF_COMPRESSION_ALG_LZO;
 		}
@@ -1001,6 +1004,8 @@ static int software_resume(void)
 	if (!(swsusp_header_flags & SF_NOCOMPRESS_MODE)) {
 		if (swsusp_header_flags & SF_COMPRESSION_ALG_LZ4)
 			strscpy(hib_comp_algo, COMPRESSION_ALGO_LZ4, sizeof(hib_comp_algo));
+		else if (swsusp_header_flags & SF_COMPRESSION_ALG_ZSTD)
+			strscpy(hib_comp_algo, COMPRESSION_ALGO_ZSTD, sizeof(hib_comp_algo));
 		else
 			strscpy(hib_comp_algo, COMPRESSION_ALGO_LZO, sizeof(hib_comp_algo));
 		if (crypto_has_comp(hib_comp_algo, 0, 0) != 1) {
@@ -1436,6 +1441,9 @@ static const char * const comp_alg_enabled[] = {
 #if IS_ENABLED(CONFIG_CRYPTO_LZ4)
 	COMPRESSION_ALGO_LZ4,
 #endif
+#if IS_ENABLED(CONFIG_CRYPTO_ZSTD)
+	COMPRESSION_ALGO_ZSTD,
+#endif
 };
 
 static int hibernate_compressor_param_set(const char *compressor,
@@ -183,8 +183,10 @@ extern int swsusp_swap_in_use(void);
  *
  * SF_CRC32_MODE, SF_COMPRESSION_ALG_LZO(dummy) -> Compression, LZO
  * SF_CRC32_MODE, SF_COMPRESSION_ALG_LZ4 -> Compression, LZ4
+ * SF_CRC32_MODE, SF_COMPRESSION_ALG_ZSTD -> Compression, ZSTD
  */
 #define SF_COMPRESSION_ALG_LZ4	16
+#define SF_COMPRESSION_ALG_ZSTD	32
 
 /* kernel/power/hibernate.c */
 int swsusp_check(bool exclusive);
@@ -533,8 +533,12 @@ static int swap_writer_finish(struct swap_map_handle *handle,
 				CMP_HEADER, PAGE_SIZE)
 #define CMP_SIZE	(CMP_PAGES * PAGE_SIZE)
 
-/* Maximum number of threads for compression/decompression. */
-#define CMP_THREADS	3
+/*
+ * Maximum number of threads for compression/decompression. Each thread
+ * costs about UNC_SIZE + CMP_SIZE of memory, and a single CRC32 thread
+ * keeps up with this many compressors.
+ */
+#define CMP_THREADS	16
 
 /* Minimum/maximum number of pages for read buffering. */
 #define CMP_MIN_RD_PAGES	1024
@@ -676,7 +680,7 @@ static int compress_threadfn(void *data)
 					      &cmp_len);
 		d->cmp_len = cmp_len;
 
-		atomic_set(&compressed_size, atomic_read(&compressed_size) + d->cmp_len);
+		atomic_add(d->cmp_len, &compressed_size);
 		atomic_set_release(&d->stop, 1);
 		wake_up(&d->done);
 	}
@@ -1068,12 +1068,30 @@ static bool nbcon_emit_next_record(struct nbcon_write_context *wctxt, bool use_a
 }
 
 /*
- * nbcon_emit_one - Print one record for an nbcon console using the
- *			specified callback
+ * Maximum number of records the printer thread emits per acquisition of
+ * the console. During log storms this saves a device lock and ownership
+ * cycle per record. A higher priority context requesting a handover is
+ * still served between records by nbcon_context_exit_unsafe().
+ *
+ * Only batch on PREEMPT_RT, where the device lock is sleepable. Otherwise
+ * it is typically the uart port lock taken with interrupts disabled, and
+ * holding it across several records of serial output would be a latency
+ * problem.
+ */
+#ifdef CONFIG_PREEMPT_RT
+#define NBCON_KTHREAD_BATCH	16
+#else
+#define NBCON_KTHREAD_BATCH	1
+#endif
+
+/*
+ * nbcon_emit_batch - Print up to @max_records records for an nbcon console
+ *			using the specified callback
  * @wctxt:	An initialized write context struct to use for this context
  * @use_atomic:	True if the write_atomic() callback is to be used
+ * @max_records: Maximum number of records to print, at least 1
  *
- * Return:	True, when a record has been printed and there are still
+ * Return:	True, when records have been printed and there are still
  *		pending records. The caller might want to continue flushing.
  *
  *		False, when there is no pending record, or when the console
@@ -1084,7 +1102,8 @@ static bool nbcon_emit_next_record(struct nbcon_write_context *wctxt, bool use_a
  * This is an internal helper to handle the locking of the console before
  * calling nbcon_emit_next_record().
  */
-static bool nbcon_emit_one(struct nbcon_write_context *wctxt, bool use_atomic)
+static bool nbcon_emit_batch(struct nbcon_write_context *wctxt, bool use_atomic,
+			     unsigned int max_records)
 {
 	struct nbcon_context *ctxt = &ACCESS_PRIVATE(wctxt, ctxt);
 	struct console *con = ctxt->console;
@@ -1112,8 +1131,11 @@ static bool nbcon_emit_one(struct nbcon_write_context *wctxt, bool use_atomic)
 	 * The higher priority printing context takes over responsibility
 	 * to print the pending records.
 	 */
-	if (!nbcon_emit_next_record(wctxt, use_atomic))
-		goto out;
+	do {
+		if (!nbcon_emit_next_record(wctxt, use_atomic))
+			goto out;
+	} while (ctxt->backlog && --max_records &&
+		 console_is_usable(con, console_srcu_read_flags(con), use_atomic));
 
 	nbcon_context_release(ctxt);
 
@@ -1124,6 +1146,11 @@ static bool nbcon_emit_one(struct nbcon_write_context *wctxt, bool use_atomic)
 	return ret;
 }
 
+static bool nbcon_emit_one(struct nbcon_write_context *wctxt, bool use_atomic)
+{
+	return nbcon_emit_batch(wctxt, use_atomic, 1);
+}
+
 /**
  * nbcon_kthread_should_wakeup - Check whether a printer thread should wakeup
  * @con:	Console to operate on
@@ -1207,7 +1234,7 @@ static int nbcon_kthread_func(void *__console)
 		con_flags = console_srcu_read_flags(con);
 
 		if (console_is_usable(con, con_flags, false))
-			backlog = nbcon_emit_one(&wctxt, false);
+			backlog = nbcon_emit_batch(&wctxt, false, NBCON_KTHREAD_BATCH);
 
 		console_srcu_read_unlock(cookie);
 
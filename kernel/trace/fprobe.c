@@ -21,9 +21,19 @@ struct fprobe_rethook_node {
 	char data[];
 };
 
+/*
+ * The number of rethook nodes in use at once is bounded by how deeply the
+ * probed functions nest and how many tasks sleep inside them, not by how
+ * many functions are probed. Cap the per-CPU share of the pool so that
+ * probing thousands of functions does not preallocate thousands of nodes
+ * on every CPU.
+ */
+#define FPROBE_RETHOOK_MAX_PER_CPU	256
+
 static inline void __fprobe_handler(unsigned long ip, unsigned long parent_ip,
 			struct ftrace_ops *ops, struct ftrace_regs *fregs)
 {
+	struct pt_regs *regs = ftrace_get_regs(fregs);
 	struct fprobe_rethook_node *fpr;
 	struct rethook_node *rh = NULL;
 	struct fprobe *fp;
@@ -46,14 +56,14 @@ static inline void __fprobe_handler(unsigned long ip, unsigned long parent_ip,
 	}
 
 	if (fp->entry_handler)
-		ret = fp->entry_handler(fp, ip, parent_ip, ftrace_get_regs(fregs), entry_data);
+		ret = fp->entry_handler(fp, ip, parent_ip, regs, entry_data);
 
 	/* If entry_handler returns !0, nmissed is not counted. */
 	if (rh) {
 		if (ret)
 			rethook_recycle(rh);
 		else
-			rethook_hook(rh, ftrace_get_regs(fregs), true);
+			rethook_hook(rh, regs, true);
 	}
 }
 
@@ -198,7 +208,7 @@ static int fprobe_init_rethook(struct fprobe *fp, int num)
 	if (fp->nr_maxactive)
 		num = fp->nr_maxactive;
 	else
-		num *= num_possible_cpus() * 2;
+		num = min(num * 2, FPROBE_RETHOOK_MAX_PER_CPU) * num_possible_cpus();
 	if (num <= 0)
 		return -EINVAL;
 
@@ -69,7 +69,12 @@
 
 /* hash bits for specific function selection */
 #define FTRACE_HASH_DEFAULT_BITS 10
-#define FTRACE_HASH_MAX_BITS 12
+/*
+ * Hashes are sized from their number of entries, so the max only
+ * matters for very large filters (e.g. coverage of most of the kernel),
+ * where long hash chains make every record update slow.
+ */
+#define FTRACE_HASH_MAX_BITS 16
 
 #ifdef CONFIG_DYNAMIC_FTRACE
 #define INIT_OPS_HASH(opsname)	\
@@ -1211,6 +1216,42 @@ static void __add_hash_entry(struct ftrace_hash *hash,
 	hash->count++;
 }
 
+/*
+ * Rehash @hash into a bucket array sized for its current number of
+ * entries.  This must only be used on hashes that are being built up
+ * and are not yet visible to the function callbacks.  Failing to grow
+ * is not an error, lookups just stay slower.
+ */
+static void ftrace_hash_grow(struct ftrace_hash *hash)
+{
+	struct ftrace_func_entry *entry;
+	struct hlist_head *buckets;
+	struct hlist_node *tn;
+	unsigned long key;
+	int bits, size, i;
+
+	bits = min(fls(hash->count), FTRACE_HASH_MAX_BITS);
+	if (bits <= hash->size_bits)
+		return;
+
+	buckets = kcalloc(1 << bits, sizeof(*buckets), GFP_KERNEL);
+	if (!buckets)
+		return;
+
+	size = 1 << hash->size_bits;
+	for (i = 0; i < size; i++) {
+		hlist_for_each_entry_safe(entry, tn, &hash->buckets[i], hlist) {
+			hlist_del(&entry->hlist);
+			key = hash_long(entry->ip, bits);
+			hlist_add_head(&entry->hlist, &buckets[key]);
+		}
+	}
+
+	kfree(hash->buckets);
+	hash->buckets = buckets;
+	hash->size_bits = bits;
+}
+
 static struct ftrace_func_entry *
 add_hash_entry(struct ftrace_hash *hash, unsigned long ip)
 {
@@ -1380,6 +1421,11 @@ alloc_and_copy_ftrace_hash(int size_bits, struct ftrace_hash *hash)
 	int size;
 	int i;
 
+	/* Don't squeeze a large hash into a small bucket array */
+	if (!ftrace_hash_empty(hash))
+		size_bits = max(size_bits,
+				min(fls(hash->count), FTRACE_HASH_MAX_BITS));
+
 	new_hash = alloc_ftrace_hash(size_bits);
 	if (!new_hash)
 		return NULL;
@@ -4717,6 +4763,9 @@ enter_record(struct ftrace_hash *hash, struct dyn_ftrace *rec, int clear_filter)
 		/* Do nothing if it exists */
 		if (entry)
 			return 0;
+		/* Keep the chains short when matching many functions */
+		if (hash->count >= (2UL << hash->size_bits))
+			ftrace_hash_grow(hash);
 		if (add_hash_entry(hash, rec->ip) == NULL)
 			ret = -ENOMEM;
 	}
@@ -10,6 +10,10 @@
 #include <uapi/linux/sched/types.h>
 #include <linux/module.h>
 #include <linux/ktime.h>
+#include <linux/hrtimer.h>
+#include <linux/nodemask.h>
+#include <linux/slab.h>
+#include <linux/delay.h>
 #include <asm/local.h>
 
 struct rb_page {
@@ -34,6 +38,38 @@ static struct task_struct *producer;
 static struct task_struct *consumer;
 static unsigned long read;
 
+/* log2 buckets of the time taken by a reserve/commit pair, in nsecs */
+#define LAT_BUCKETS	24
+
+struct rb_write_stats {
+	unsigned long	hit;
+	unsigned long	missed;
+	unsigned long	lat[LAT_BUCKETS];
+};
+
+struct rb_helper {
+	struct task_struct	*task;
+	struct rb_write_stats	stats;
+	unsigned long		read;
+};
+
+static struct rb_write_stats producer_stats;
+static struct rb_write_stats irq_stats;
+
+/*
+ * Extra writers and readers only run while the producer is hammering
+ * the buffer: the producer bumps hammer_gen to start them and clears
+ * hammer_running to stop them, then waits for helpers_active to drop
+ * to zero.
+ */
+static struct rb_helper *writers;
+static struct rb_helper *readers;
+static int hammer_gen;
+static bool hammer_running;
+static atomic_t helpers_active;
+static DECLARE_WAIT_QUEUE_HEAD(hammer_wait);
+static struct hrtimer irq_writer_timer;
+
 static unsigned int disable_reader;
 module_param(disable_reader, uint, 0644);
 MODULE_PARM_DESC(disable_reader, "only run producer");
@@ -42,6 +78,18 @@ static unsigned int write_iteration = 50;
 module_param(write_iteration, uint, 0644);
 MODULE_PARM_DESC(write_iteration, "# of writes between timestamp readings");
 
+static unsigned int nr_writers;
+module_param(nr_writers, uint, 0444);
+MODULE_PARM_DESC(nr_writers, "# of extra writer threads, spread over the NUMA nodes");
+
+static unsigned int nr_readers;
+module_param(nr_readers, uint, 0444);
+MODULE_PARM_DESC(nr_readers, "# of extra page reader threads");
+
+static unsigned int irq_writer_us;
+module_param(irq_writer_us, uint, 0444);
+MODULE_PARM_DESC(irq_writer_us, "period of the hrtimer writer in usecs (0 - disabled)");
+
 static int producer_nice = MAX_NICE;
 static int consumer_nice = MAX_NICE;
 
@@ -82,7 +130,7 @@ static bool break_test(void)
 	return test_error || kthread_should_stop();
 }
 
-static enum event_status read_event(int cpu)
+static enum event_status read_event(int cpu, unsigned long *nr_read)
 {
 	struct ring_buffer_event *event;
 	int *entry;
@@ -98,11 +146,11 @@ static enum event_status read_event(int cpu)
 		return EVENT_DROPPED;
 	}
 
-	read++;
+	(*nr_read)++;
 	return EVENT_FOUND;
 }
 
-static enum event_status read_page(int cpu)
+static enum event_status read_page(int cpu, unsigned long *nr_read)
 {
 	struct buffer_data_read_page *bpage;
 	struct ring_buffer_event *event;
@@ -149,7 +197,7 @@ static enum event_status read_page(int cpu)
 					TEST_ERROR();
 					break;
 				}
-				read++;
+				(*nr_read)++;
 				if (!event->array[0]) {
 					TEST_ERROR();
 					break;
@@ -162,7 +210,7 @@ static enum event_status read_page(int cpu)
 					TEST_ERROR();
 					break;
 				}
-				read++;
+				(*nr_read)++;
 				inc = ((event->type_len + 1) * 4);
 			}
 			if (test_error)
@@ -202,9 +250,9 @@ static void ring_buffer_consumer(void)
 				enum event_status stat;
 
 				if (read_events)
-					stat = read_event(cpu);
+					stat = read_event(cpu, &read);
 				else
-					stat = read_page(cpu);
+					stat = read_page(cpu, &read);
 
 				if (test_error)
 					break;
@@ -229,40 +277,133 @@ static void ring_buffer_consumer(void)
 	complete(&read_done);
 }
 
+static void write_events(struct rb_write_stats *stats, int nr)
+{
+	struct ring_buffer_event *event;
+	u64 start = 0;
+	int *entry;
+	int i;
+
+	for (i = 0; i < nr; i++) {
+		/* Only time the first write of each batch */
+		if (!i)
+			start = local_clock();
+
+		event = ring_buffer_lock_reserve(buffer, 10);
+		if (!event) {
+			stats->missed++;
+		} else {
+			stats->hit++;
+			entry = ring_buffer_event_data(event);
+			*entry = smp_processor_id();
+			ring_buffer_unlock_commit(buffer);
+		}
+
+		if (!i) {
+			u64 delta = local_clock() - start;
+
+			stats->lat[min_t(int, fls64(delta), LAT_BUCKETS - 1)]++;
+		}
+	}
+}
+
+static void add_write_stats(struct rb_write_stats *to,
+			    struct rb_write_stats *from)
+{
+	int i;
+
+	to->hit += from->hit;
+	to->missed += from->missed;
+	for (i = 0; i < LAT_BUCKETS; i++)
+		to->lat[i] += from->lat[i];
+}
+
+static void print_lat_histogram(struct rb_write_stats *stats)
+{
+	int i;
+
+	trace_printk("Write latency histogram (ns):\n");
+	for (i = 0; i < LAT_BUCKETS; i++) {
+		if (!stats->lat[i])
+			continue;
+		if (i == LAT_BUCKETS - 1)
+			trace_printk("  >= %10llu: %lu\n", 1ULL << (i - 1),
+				     stats->lat[i]);
+		else
+			trace_printk("  < %11llu: %lu\n", 1ULL << i,
+				     stats->lat[i]);
+	}
+}
+
+static enum hrtimer_restart irq_writer_fn(struct hrtimer *timer)
+{
+	write_events(&irq_stats, write_iteration);
+
+	if (!READ_ONCE(hammer_running))
+		return HRTIMER_NORESTART;
+
+	hrtimer_forward_now(timer, us_to_ktime(irq_writer_us));
+	return HRTIMER_RESTART;
+}
+
+static void start_helpers(void)
+{
+	int i;
+
+	memset(&irq_stats, 0, sizeof(irq_stats));
+	for (i = 0; i < nr_writers; i++)
+		memset(&writers[i].stats, 0, sizeof(writers[i].stats));
+	for (i = 0; i < nr_readers; i++)
+		readers[i].read = 0;
+
+	atomic_set(&helpers_active, nr_writers + nr_readers);
+	WRITE_ONCE(hammer_running, true);
+	/* hammer_running must be visible before the new generation */
+	smp_wmb();
+	WRITE_ONCE(hammer_gen, hammer_gen + 1);
+	wake_up_all(&hammer_wait);
+
+	if (irq_writer_us)
+		hrtimer_start(&irq_writer_timer, us_to_ktime(irq_writer_us),
+			      HRTIMER_MODE_REL_PINNED_HARD);
+}
+
+static void stop_helpers(void)
+{
+	WRITE_ONCE(hammer_running, false);
+
+	if (irq_writer_us)
+		hrtimer_cancel(&irq_writer_timer);
+
+	wait_event(hammer_wait, !atomic_read(&helpers_active));
+}
+
 static void ring_buffer_producer(void)
 {
 	ktime_t start_time, end_time, timeout;
+	struct rb_write_stats total = {};
 	unsigned long long time;
 	unsigned long long entries;
 	unsigned long long overruns;
+	unsigned long helpers_read = 0;
 	unsigned long missed = 0;
 	unsigned long hit = 0;
 	unsigned long avg;
 	int cnt = 0;
+	int i;
+
+	memset(&producer_stats, 0, sizeof(producer_stats));
 
 	/*
 	 * Hammer the buffer for 10 secs (this may
 	 * make the system stall)
 	 */
 	trace_printk("Starting ring buffer hammer\n");
+	start_helpers();
 	start_time = ktime_get();
 	timeout = ktime_add_ns(start_time, RUN_TIME * NSEC_PER_SEC);
 	do {
-		struct ring_buffer_event *event;
-		int *entry;
-		int i;
-
-		for (i = 0; i < write_iteration; i++) {
-			event = ring_buffer_lock_reserve(buffer, 10);
-			if (!event) {
-				missed++;
-			} else {
-				hit++;
-				entry = ring_buffer_event_data(event);
-				*entry = smp_processor_id();
-				ring_buffer_unlock_commit(buffer);
-			}
-		}
+		write_events(&producer_stats, write_iteration);
 		end_time = ktime_get();
 
 		cnt++;
@@ -283,6 +424,7 @@ static void ring_buffer_producer(void)
 			cond_resched();
 #endif
 	} while (ktime_before(end_time, timeout) && !break_test());
+	stop_helpers();
 	trace_printk("End ring buffer hammer\n");
 
 	if (consumer) {
@@ -298,6 +440,15 @@ static void ring_buffer_producer(void)
 
 	time = ktime_us_delta(end_time, start_time);
 
+	add_write_stats(&total, &producer_stats);
+	add_write_stats(&total, &irq_stats);
+	for (i = 0; i < nr_writers; i++)
+		add_write_stats(&total, &writers[i].stats);
+	for (i = 0; i < nr_readers; i++)
+		helpers_read += readers[i].read;
+	hit = total.hit;
+	missed = total.missed;
+
 	entries = ring_buffer_entries(buffer);
 	overruns = ring_buffer_overruns(buffer);
 
@@ -324,6 +475,12 @@ static void ring_buffer_producer(void)
 	    producer_nice == MAX_NICE && consumer_nice == MAX_NICE)
 		trace_printk("WARNING!!! This test is running at lowest priority.\n");
 
+	if (nr_writers)
+		trace_printk("Extra writers: %u\n", nr_writers);
+	if (irq_writer_us)
+		trace_printk("IRQ writer every %u usecs: %ld hit %ld missed\n",
+			     irq_writer_us, irq_stats.hit, irq_stats.missed);
+
 	trace_printk("Time:     %lld (usecs)\n", time);
 	trace_printk("Overruns: %lld\n", overruns);
 	if (disable_reader)
@@ -331,11 +488,16 @@ static void ring_buffer_producer(void)
 	else
 		trace_printk("Read:     %ld  (by %s)\n", read,
 			read_events ? "events" : "pages");
+	if (nr_readers)
+		trace_printk("Read:     %ld  (by %u extra readers)\n",
+			     helpers_read, nr_readers);
 	trace_printk("Entries:  %lld\n", entries);
-	trace_printk("Total:    %lld\n", entries + overruns + read);
+	trace_printk("Total:    %lld\n", entries + overruns + read + helpers_read);
 	trace_printk("Missed:   %ld\n", missed);
 	trace_printk("Hit:      %ld\n", hit);
 
+	print_lat_histogram(&total);
+
 	/* Convert time from usecs to millisecs */
 	do_div(time, USEC_PER_MSEC);
 	if (time)
@@ -380,6 +542,148 @@ static void wait_to_die(void)
 	__set_current_state(TASK_RUNNING);
 }
 
+/* Wait for the producer to start a new hammer run */
+static bool wait_for_hammer(int *gen)
+{
+	wait_event_interruptible(hammer_wait, READ_ONCE(hammer_gen) != *gen ||
+				 kthread_should_stop());
+	if (kthread_should_stop())
+		return false;
+
+	*gen = READ_ONCE(hammer_gen);
+	/* Pairs with the smp_wmb() in start_helpers() */
+	smp_rmb();
+	return true;
+}
+
+static void helper_done(void)
+{
+	if (atomic_dec_and_test(&helpers_active))
+		wake_up_all(&hammer_wait);
+}
+
+static int ring_buffer_writer_thread(void *arg)
+{
+	struct rb_helper *writer = arg;
+	int gen = 0;
+
+	while (wait_for_hammer(&gen)) {
+		while (READ_ONCE(hammer_running) && !test_error) {
+			write_events(&writer->stats, write_iteration);
+			cond_resched();
+		}
+		helper_done();
+	}
+
+	return 0;
+}
+
+static int ring_buffer_reader_thread(void *arg)
+{
+	struct rb_helper *reader = arg;
+	int gen = 0;
+	int found;
+	int cpu;
+
+	while (wait_for_hammer(&gen)) {
+		while (READ_ONCE(hammer_running) && !test_error) {
+			found = 0;
+			for_each_online_cpu(cpu) {
+				if (read_page(cpu, &reader->read) == EVENT_FOUND)
+					found = 1;
+			}
+			if (!found)
+				usleep_range(100, 200);
+			else
+				cond_resched();
+		}
+		helper_done();
+	}
+
+	return 0;
+}
+
+/* Pick the CPU of the idx'th writer, going round-robin over the nodes */
+static int writer_cpu(unsigned int idx)
+{
+	unsigned int nodes = num_online_nodes();
+	const struct cpumask *mask;
+	unsigned int weight;
+	int node = first_online_node;
+	unsigned int n;
+
+	for (n = idx % nodes; n; n--)
+		node = next_online_node(node);
+
+	mask = cpumask_of_node(node);
+	weight = cpumask_weight_and(mask, cpu_online_mask);
+	if (!weight)
+		return cpumask_nth(idx % num_online_cpus(), cpu_online_mask);
+
+	return cpumask_nth_and((idx / nodes) % weight, mask, cpu_online_mask);
+}
+
+static void stop_helper_threads(void)
+{
+	int i;
+
+	for (i = 0; writers && i < nr_writers; i++)
+		if (writers[i].task)
+			kthread_stop(writers[i].task);
+	for (i = 0; readers && i < nr_readers; i++)
+		if (readers[i].task)
+			kthread_stop(readers[i].task);
+
+	kfree(writers);
+	kfree(readers);
+	writers = NULL;
+	readers = NULL;
+}
+
+static int start_helper_threads(void)
+{
+	struct task_struct *task;
+	int cpu;
+	int i;
+
+	writers = kcalloc(nr_writers, sizeof(*writers), GFP_KERNEL);
+	readers = kcalloc(nr_readers, sizeof(*readers), GFP_KERNEL);
+	if ((nr_writers && !writers) || (nr_readers && !readers))
+		goto fail;
+
+	for (i = 0; i < nr_writers; i++) {
+		cpu = writer_cpu(i);
+		task = kthread_create_on_node(ring_buffer_writer_thread,
+					      &writers[i], cpu_to_node(cpu),
+					      "rb_writer/%d", i);
+		if (IS_ERR(task))
+			goto fail;
+		kthread_bind(task, cpu);
+		if (producer_fifo >= 2)
+			sched_set_fifo(task);
+		else if (producer_fifo == 1)
+			sched_set_fifo_low(task);
+		else
+			set_user_nice(task, producer_nice);
+		writers[i].task = task;
+		wake_up_process(task);
+	}
+
+	for (i = 0; i < nr_readers; i++) {
+		task = kthread_run(ring_buffer_reader_thread, &readers[i],
+				   "rb_reader/%d", i);
+		if (IS_ERR(task))
+			goto fail;
+		set_user_nice(task, consumer_nice);
+		readers[i].task = task;
+	}
+
+	return 0;
+ fail:
+	stop_helper_threads();
+	return -ENOMEM;
+}
+
 static int ring_buffer_consumer_thread(void *arg)
 {
 	while (!break_test()) {
@@ -438,12 +742,19 @@ static int __init ring_buffer_benchmark_init(void)
 	if (!buffer)
 		return -ENOMEM;
 
+	hrtimer_setup(&irq_writer_timer, irq_writer_fn, CLOCK_MONOTONIC,
+		      HRTIMER_MODE_REL_PINNED_HARD);
+
+	ret = start_helper_threads();
+	if (ret)
+		goto out_fail;
+
 	if (!disable_reader) {
 		consumer = kthread_create(ring_buffer_consumer_thread,
 					  NULL, "rb_consumer");
 		ret = PTR_ERR(consumer);
 		if (IS_ERR(consumer))
-			goto out_fail;
+			goto out_helpers;
 	}
 
 	producer = kthread_run(ring_buffer_producer_thread,
@@ -478,6 +789,8 @@ static int __init ring_buffer_benchmark_init(void)
 	if (consumer)
 		kthread_stop(consumer);
 
+ out_helpers:
+	stop_helper_threads();
  out_fail:
 	ring_buffer_free(buffer);
 	return ret;
@@ -488,6 +801,7 @@ static void __exit ring_buffer_benchmark_exit(void)
 	kthread_stop(producer);
 	if (consumer)
 		kthread_stop(consumer);
+	stop_helper_threads();
 	ring_buffer_free(buffer);
 }
 
@@ -5523,6 +5523,8 @@ static const char readme_msg[] =
 	"  trace\t\t\t- The static contents of the buffer\n"
 	"\t\t\t  To clear the buffer write into this file: echo > trace\n"
 	"  trace_pipe\t\t- A consuming read to see the contents of the buffer\n"
+	"  trace_pipe_raw\t- A consuming read of the raw sub-buffers of all CPUs,\n"
+	"\t\t\t  each preceded by a header with its CPU and size\n"
 	"  current_tracer\t- function and latency tracers\n"
 	"  available_tracers\t- list of configured tracers for current_tracer\n"
 	"  error_log\t- error log for failed commands (that support it)\n"
@@ -5724,6 +5726,7 @@ static const char readme_msg[] =
 	"\t            [:pause][:continue][:clear]\n"
 	"\t            [:name=histname1]\n"
 	"\t            [:nohitcount]\n"
+	"\t            [:percpu]\n"
 	"\t            [:<handler>.<action>]\n"
 	"\t            [if <filter>]\n\n"
 	"\t    Note, special fields can be used as well:\n"
@@ -5760,7 +5763,9 @@ static const char readme_msg[] =
 	"\t    triggers attached to an event, there will be a table for each\n"
 	"\t    trigger in the output.  The table displayed for a named\n"
 	"\t    trigger will be the same as any other instance having the\n"
-	"\t    same name.  The default format used to display a given field\n"
+	"\t    same name.  The 'hist_raw' file contains the same data as\n"
+	"\t    unsorted binary records (see <linux/trace_hist_raw.h>).\n"
+	"\t    The default format used to display a given field\n"
 	"\t    can be modified by appending any of the following modifiers\n"
 	"\t    to the field name, as applicable:\n\n"
 	"\t            .hex        display a number as a hex value\n"
@@ -5782,6 +5787,9 @@ static const char readme_msg[] =
 	"\t    unchanged.\n\n"
 	"\t    The 'nohitcount' (or NOHC) parameter will suppress display of\n"
 	"\t    raw hitcount in the histogram.\n\n"
+	"\t    The 'percpu' parameter makes each CPU aggregate into its own\n"
+	"\t    copy of the sums, which are merged when the histogram is read.\n"
+	"\t    This uses more memory but scales better on busy events.\n\n"
 	"\t    The enable_hist and disable_hist triggers can be used to\n"
 	"\t    have one event conditionally start and stop another event's\n"
 	"\t    already-attached hist trigger.  The syntax is analogous to\n"
@@ -7369,6 +7377,7 @@ struct ftrace_buffer_info {
 	unsigned int		spare_cpu;
 	unsigned int		spare_size;
 	unsigned int		read;
+	unsigned int		last_cpu;
 };
 
 #ifdef CONFIG_TRACER_SNAPSHOT
@@ -8168,6 +8177,118 @@ tracing_buffers_read(struct file *filp, char __user *ubuf,
 	return size;
 }
 
+/*
+ * Read one sub-buffer of @cpu and copy it to @ubuf, preceded by a
+ * struct trace_pipe_raw_header.  Returns the number of bytes copied,
+ * 0 if there was nothing to read on @cpu, or a negative error.
+ */
+static ssize_t tracing_buffers_read_cpu_page(struct trace_buffer *buffer,
+					     char __user *ubuf, int cpu,
+					     int page_size)
+{
+	struct trace_pipe_raw_header hdr = { .cpu = cpu, .size = page_size };
+	struct buffer_data_read_page *page;
+	ssize_t ret;
+
+	if (ring_buffer_empty_cpu(buffer, cpu))
+		return 0;
+
+	page = ring_buffer_alloc_read_page(buffer, cpu);
+	if (IS_ERR(page))
+		return PTR_ERR(page);
+
+	trace_access_lock(cpu);
+	ret = ring_buffer_read_page(buffer, page, page_size, cpu, 0);
+	trace_access_unlock(cpu);
+
+	if (ret < 0) {
+		ret = 0;
+		goto out;
+	}
+
+	if (copy_to_user(ubuf, &hdr, sizeof(hdr)) ||
+	    copy_to_user(ubuf + sizeof(hdr), ring_buffer_read_page_data(page),
+			 page_size)) {
+		ret = -EFAULT;
+		goto out;
+	}
+
+	ret = sizeof(hdr) + page_size;
+ out:
+	ring_buffer_free_read_page(buffer, cpu, page);
+
+	return ret;
+}
+
+/*
+ * The top level trace_pipe_raw file drains the sub-buffers of all
+ * CPUs in one read, each tagged with the CPU it came from, so that a
+ * consumer doesn't need a syscall per CPU.  Only whole sub-buffers
+ * are returned, and the CPUs are visited round-robin, one sub-buffer
+ * each per pass, so a busy CPU can't starve the others.
+ */
+static ssize_t
+tracing_buffers_read_all(struct file *filp, char __user *ubuf,
+			 size_t count, loff_t *ppos)
+{
+	struct ftrace_buffer_info *info = filp->private_data;
+	struct trace_iterator *iter = &info->iter;
+	struct trace_buffer *buffer;
+	size_t rec_size, read = 0;
+	bool progress;
+	int page_size, cpu, n;
+	ssize_t ret;
+
+#ifdef CONFIG_TRACER_MAX_TRACE
+	if (iter->snapshot && iter->tr->current_trace->use_max_tr)
+		return -EBUSY;
+#endif
+
+	buffer = iter->array_buffer->buffer;
+	page_size = ring_buffer_subbuf_size_get(buffer);
+	rec_size = sizeof(struct trace_pipe_raw_header) + page_size;
+
+	if (count < rec_size)
+		return -EINVAL;
+
+ again:
+	do {
+		progress = false;
+		cpu = info->last_cpu;
+		for (n = 0; n < nr_cpu_ids && count - read >= rec_size; n++) {
+			cpu = (cpu + 1) % nr_cpu_ids;
+			if (!cpu_possible(cpu))
+				continue;
+
+			ret = tracing_buffers_read_cpu_page(buffer, ubuf + read,
+							    cpu, page_size);
+			if (ret < 0)
+				return read ? read : ret;
+
+			if (ret) {
+				read += ret;
+				progress = true;
+				info->last_cpu = cpu;
+			}
+		}
+	} while (progress && count - read >= rec_size);
+
+	if (!read && !iter->closed) {
+		if (filp->f_flags & O_NONBLOCK)
+			return -EAGAIN;
+
+		ret = wait_on_pipe(iter, 0);
+		if (ret)
+			return ret;
+
+		goto again;
+	}
+
+	*ppos += read;
+
+	return read;
+}
+
 static int tracing_buffers_flush(struct file *file, fl_owner_t id)
 {
 	struct ftrace_buffer_info *info = file->private_data;
@@ -8499,6 +8620,14 @@ static const struct file_operations tracing_buffers_fops = {
 	.mmap		= tracing_buffers_mmap,
 };
 
+static const struct file_operations tracing_buffers_all_fops = {
+	.open		= tracing_buffers_open,
+	.read		= tracing_buffers_read_all,
+	.poll		= tracing_buffers_poll,
+	.release	= tracing_buffers_release,
+	.flush		= tracing_buffers_flush,
+};
+
 static ssize_t
 tracing_stats_read(struct file *filp, char __user *ubuf,
 		   size_t count, loff_t *ppos)
@@ -9872,6 +10001,9 @@ init_tracer_tracefs(struct trace_array *tr, struct dentry *d_tracer)
 	trace_create_file("trace_pipe", TRACE_MODE_READ, d_tracer,
 			  tr, &tracing_pipe_fops);
 
+	trace_create_file("trace_pipe_raw", TRACE_MODE_READ, d_tracer,
+			  tr, &tracing_buffers_all_fops);
+
 	trace_create_file("buffer_size_kb", TRACE_MODE_WRITE, d_tracer,
 			  tr, &tracing_entries_fops);
 
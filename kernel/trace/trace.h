@@ -1419,8 +1419,11 @@ struct ftrace_event_field {
 
 struct prog_entry;
 
+struct filter_value_set;
+
 struct event_filter {
 	struct prog_entry __rcu	*prog;
+	struct filter_value_set	*vset;
 	char			*filter_string;
 };
 
@@ -1676,6 +1679,7 @@ static inline struct trace_event_file *event_file_file(struct file *filp)
 
 extern const struct file_operations event_trigger_fops;
 extern const struct file_operations event_hist_fops;
+extern const struct file_operations event_hist_raw_fops;
 extern const struct file_operations event_hist_debug_fops;
 extern const struct file_operations event_inject_fops;
 
@@ -995,11 +995,17 @@ void event_file_get(struct trace_event_file *file)
 	refcount_inc(&file->ref);
 }
 
+static void event_file_free(struct trace_event_file *file)
+{
+	free_percpu(file->sample);
+	kmem_cache_free(file_cachep, file);
+}
+
 void event_file_put(struct trace_event_file *file)
 {
 	if (WARN_ON_ONCE(!refcount_read(&file->ref))) {
 		if (file->flags & EVENT_FILE_FL_FREED)
-			kmem_cache_free(file_cachep, file);
+			event_file_free(file);
 		return;
 	}
 
@@ -1007,7 +1013,7 @@ void event_file_put(struct trace_event_file *file)
 		/* Count should only go to zero when it is freed */
 		if (WARN_ON_ONCE(!(file->flags & EVENT_FILE_FL_FREED)))
 			return;
-		kmem_cache_free(file_cachep, file);
+		event_file_free(file);
 	}
 }
 
@@ -1445,6 +1451,92 @@ event_enable_write(struct file *filp, const char __user *ubuf, size_t cnt,
 	return ret ? ret : cnt;
 }
 
+static ssize_t
+event_sample_read(struct file *filp, char __user *ubuf, size_t cnt,
+		  loff_t *ppos)
+{
+	struct trace_event_file *file;
+	unsigned long sampled_out = 0;
+	unsigned int period = 0;
+	char buf[64];
+	int cpu, len;
+
+	mutex_lock(&event_mutex);
+	file = event_file_file(filp);
+	if (likely(file)) {
+		period = file->sample_period;
+		if (file->sample) {
+			for_each_possible_cpu(cpu)
+				sampled_out += per_cpu_ptr(file->sample, cpu)->sampled_out;
+		}
+	}
+	mutex_unlock(&event_mutex);
+
+	if (!file)
+		return -ENODEV;
+
+	len = scnprintf(buf, sizeof(buf), "period: %u\nsampled out: %lu\n",
+			period, sampled_out);
+
+	return simple_read_from_buffer(ubuf, cnt, ppos, buf, len);
+}
+
+/*
+ * Writing N to the sample file only records one in every N hits of
+ * the event, counted per CPU.  Writing 0 or 1 records every hit again.
+ * The hits that are dropped never reach the ring buffer, the filter or
+ * the triggers of the event, and are counted in "sampled out".
+ */
+static ssize_t
+event_sample_write(struct file *filp, const char __user *ubuf, size_t cnt,
+		   loff_t *ppos)
+{
+	struct trace_event_sample __percpu *sample;
+	struct trace_event_file *file;
+	unsigned int period;
+	int ret;
+
+	ret = kstrtouint_from_user(ubuf, cnt, 10, &period);
+	if (ret)
+		return ret;
+
+	mutex_lock(&event_mutex);
+	file = event_file_file(filp);
+	if (unlikely(!file)) {
+		ret = -ENODEV;
+		goto out;
+	}
+
+	if (period <= 1) {
+		clear_bit(EVENT_FILE_FL_SAMPLED_BIT, &file->flags);
+		WRITE_ONCE(file->sample_period, 0);
+		goto out;
+	}
+
+	if (!file->sample) {
+		sample = alloc_percpu(struct trace_event_sample);
+		if (!sample) {
+			ret = -ENOMEM;
+			goto out;
+		}
+		file->sample = sample;
+	}
+
+	WRITE_ONCE(file->sample_period, period);
+	/* The per-CPU state must be visible before the flag is */
+	smp_wmb();
+	set_bit(EVENT_FILE_FL_SAMPLED_BIT, &file->flags);
+ out:
+	mutex_unlock(&event_mutex);
+
+	if (ret)
+		return ret;
+
+	*ppos += cnt;
+
+	return cnt;
+}
+
 static ssize_t
 system_enable_read(struct file *filp, char __user *ubuf, size_t cnt,
 		   loff_t *ppos)
@@ -2169,6 +2261,14 @@ static const struct file_operations ftrace_event_id_fops = {
 };
 #endif
 
+static const struct file_operations ftrace_event_sample_fops = {
+	.open = tracing_open_file_tr,
+	.read = event_sample_read,
+	.write = event_sample_write,
+	.release = tracing_release_file_tr,
+	.llseek = default_llseek,
+};
+
 static const struct file_operations ftrace_event_filter_fops = {
 	.open = tracing_open_file_tr,
 	.read = event_filter_read,
@@ -2513,6 +2613,12 @@ static int event_callback(const char *name, umode_t *mode, void **data,
 			*fops = &ftrace_event_filter_fops;
 			return 1;
 		}
+
+		if (strcmp(name, "sample") == 0) {
+			*mode = TRACE_MODE_WRITE;
+			*fops = &ftrace_event_sample_fops;
+			return 1;
+		}
 	}
 
 	if (!(call->flags & TRACE_EVENT_FL_IGNORE_ENABLE) ||
@@ -2540,6 +2646,11 @@ static int event_callback(const char *name, umode_t *mode, void **data,
 		*fops = &event_hist_fops;
 		return 1;
 	}
+	if (strcmp(name, "hist_raw") == 0) {
+		*mode = TRACE_MODE_READ;
+		*fops = &event_hist_raw_fops;
+		return 1;
+	}
 #endif
 #ifdef CONFIG_HIST_TRIGGERS_DEBUG
 	if (strcmp(name, "hist_debug") == 0) {
@@ -2591,6 +2702,10 @@ event_create_dir(struct eventfs_inode *parent, struct trace_event_file *file)
 			.name		= "trigger",
 			.callback	= event_callback,
 		},
+		{
+			.name		= "sample",
+			.callback	= event_callback,
+		},
 		{
 			.name		= "format",
 			.callback	= event_callback,
@@ -2606,6 +2721,10 @@ event_create_dir(struct eventfs_inode *parent, struct trace_event_file *file)
 			.name		= "hist",
 			.callback	= event_callback,
 		},
+		{
+			.name		= "hist_raw",
+			.callback	= event_callback,
+		},
 #endif
 #ifdef CONFIG_HIST_TRIGGERS_DEBUG
 		{
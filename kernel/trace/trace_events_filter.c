@@ -11,6 +11,8 @@
 #include <linux/mutex.h>
 #include <linux/perf_event.h>
 #include <linux/slab.h>
+#include <linux/sort.h>
+#include <linux/bsearch.h>
 
 #include "trace.h"
 #include "trace_output.h"
@@ -1167,9 +1169,146 @@ static int test_pred_visited_fn(struct filter_pred *pred, void *event)
 
 static int filter_pred_fn_call(struct filter_pred *pred, void *event);
 
+/*
+ * A filter that only tests one integer field against a list of
+ * values, such as "common_pid == 1 || common_pid == 2 || ...", or its
+ * negation "pid != 1 && pid != 2 && ...", is turned into a sorted
+ * array of values when it is created.  Matching an event then only
+ * needs one load of the field and a search of the array instead of
+ * walking the whole program.
+ */
+#define FILTER_VSET_LINEAR	8
+
+struct filter_value_set {
+	int		offset;
+	int		size;
+	int		not;
+	unsigned int	nr_vals;
+	u64		vals[];
+};
+
+static int cmp_vset_val(const void *a, const void *b)
+{
+	u64 va = *(const u64 *)a;
+	u64 vb = *(const u64 *)b;
+
+	return va < vb ? -1 : va > vb;
+}
+
+static int filter_value_set_match(struct filter_value_set *vset, void *rec)
+{
+	void *addr = rec + vset->offset;
+	unsigned int i;
+	u64 val;
+
+	switch (vset->size) {
+	case 8:
+		val = *(u64 *)addr;
+		break;
+	case 4:
+		val = *(u32 *)addr;
+		break;
+	case 2:
+		val = *(u16 *)addr;
+		break;
+	default:
+		val = *(u8 *)addr;
+		break;
+	}
+
+	if (vset->nr_vals <= FILTER_VSET_LINEAR) {
+		for (i = 0; i < vset->nr_vals; i++) {
+			if (vset->vals[i] == val)
+				return !vset->not;
+		}
+		return vset->not;
+	}
+
+	if (bsearch(&val, vset->vals, vset->nr_vals, sizeof(u64), cmp_vset_val))
+		return !vset->not;
+	return vset->not;
+}
+
+static int pred_value_size(struct filter_pred *pred)
+{
+	switch (pred->fn_num) {
+	case FILTER_PRED_FN_64:
+		return 8;
+	case FILTER_PRED_FN_32:
+		return 4;
+	case FILTER_PRED_FN_16:
+		return 2;
+	case FILTER_PRED_FN_8:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/*
+ * See the comment above predicate_parse() for the program layout.  Entry
+ * N is TRUE and N + 1 is FALSE, and taking a branch of entry i
+ * continues at prog[i].target + 1.  For "a == x || a == y || a == z"
+ * every entry but the last branches to TRUE when it matches, and the
+ * last one branches to FALSE when it doesn't.  For the negated
+ * "a != x && a != y && a != z" every entry branches to FALSE when it
+ * doesn't match.
+ */
+static struct filter_value_set *build_value_set(struct prog_entry *prog)
+{
+	struct filter_value_set *vset;
+	struct filter_pred *pred;
+	int size, not, N, i;
+
+	for (N = 0; prog[N].pred; N++)
+		;
+	if (N < 2)
+		return NULL;
+
+	size = pred_value_size(prog[0].pred);
+	not = prog[0].pred->not;
+	if (!size)
+		return NULL;
+
+	for (i = 0; i < N; i++) {
+		pred = prog[i].pred;
+		if (pred_value_size(pred) != size || pred->not != not ||
+		    pred->offset != prog[0].pred->offset)
+			return NULL;
+
+		if (i == N - 1 || not) {
+			if (prog[i].when_to_branch || prog[i].target != N)
+				return NULL;
+		} else {
+			if (!prog[i].when_to_branch || prog[i].target != N - 1)
+				return NULL;
+		}
+	}
+
+	vset = kmalloc(struct_size(vset, vals, N), GFP_KERNEL);
+	if (!vset)
+		return NULL;
+
+	vset->offset = prog[0].pred->offset;
+	vset->size = size;
+	vset->not = not;
+	vset->nr_vals = N;
+	for (i = 0; i < N; i++) {
+		u64 val = prog[i].pred->val;
+
+		if (size < 8)
+			val &= (1ULL << (size * BITS_PER_BYTE)) - 1;
+		vset->vals[i] = val;
+	}
+	sort(vset->vals, N, sizeof(u64), cmp_vset_val, NULL);
+
+	return vset;
+}
+
 /* return 1 if event matches, 0 otherwise (discard) */
 int filter_match_preds(struct event_filter *filter, void *rec)
 {
+	struct filter_value_set *vset;
 	struct prog_entry *prog;
 	int i;
 
@@ -1182,6 +1321,10 @@ int filter_match_preds(struct event_filter *filter, void *rec)
 	if (!prog)
 		return 1;
 
+	vset = READ_ONCE(filter->vset);
+	if (vset)
+		return filter_value_set_match(vset, rec);
+
 	for (i = 0; prog[i].pred; i++) {
 		struct filter_pred *pred = prog[i].pred;
 		int match = filter_pred_fn_call(pred, rec);
@@ -1308,6 +1451,7 @@ static void __free_filter(struct event_filter *filter)
 		return;
 
 	free_prog(filter);
+	kfree(filter->vset);
 	kfree(filter->filter_string);
 	kfree(filter);
 }
@@ -2106,6 +2250,8 @@ static int process_preds(struct trace_event_call *call,
 	if (IS_ERR(prog))
 		return PTR_ERR(prog);
 
+	/* Not finding a faster way to evaluate the filter is not an error */
+	filter->vset = build_value_set(prog);
 	rcu_assign_pointer(filter->prog, prog);
 	return 0;
 }
@@ -2718,6 +2864,20 @@ static struct test_filter_data_t {
 	DATA_REC(YES, 1, 1, 1, 1, 1, 1, 1, 1, "bdfh"),
 	DATA_REC(YES, 0, 1, 0, 1, 0, 1, 0, 1, ""),
 	DATA_REC(YES, 1, 0, 1, 0, 1, 0, 1, 0, "bdfh"),
+#undef FILTER
+#define FILTER "a == 1 || a == 2 || a == 3 || a == 4 || a == 5 || " \
+	       "a == 6 || a == 7 || a == 8 || a == 9"
+	DATA_REC(YES, 9, 0, 0, 0, 0, 0, 0, 0, ""),
+	DATA_REC(YES, 1, 0, 0, 0, 0, 0, 0, 0, ""),
+	DATA_REC(NO,  0, 1, 2, 3, 4, 5, 6, 7, ""),
+#undef FILTER
+#define FILTER "a != 1 && a != 2 && a != 3"
+	DATA_REC(YES, 4, 1, 2, 3, 0, 0, 0, 0, ""),
+	DATA_REC(NO,  2, 0, 0, 0, 0, 0, 0, 0, ""),
+#undef FILTER
+#define FILTER "!(a == 1 || a == 2)"
+	DATA_REC(YES, 3, 1, 1, 1, 1, 1, 1, 1, ""),
+	DATA_REC(NO,  1, 0, 0, 0, 0, 0, 0, 0, ""),
 };
 
 #undef DATA_REC
@@ -2760,6 +2920,10 @@ static void update_pred_fn(struct event_filter *filter, char *fields)
 
 		pred->fn_num = FILTER_PRED_TEST_VISITED;
 	}
+
+	/* The value set no longer reflects the predicates */
+	kfree(filter->vset);
+	filter->vset = NULL;
 }
 
 static __init int ftrace_test_event_filter(void)
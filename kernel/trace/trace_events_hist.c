@@ -17,6 +17,7 @@
 /* for gfp flag names */
 #include <linux/trace_events.h>
 #include <trace/events/mmflags.h>
+#include <uapi/linux/trace_hist_raw.h>
 
 #include "tracing_map.h"
 #include "trace_synth.h"
@@ -525,6 +526,7 @@ struct hist_trigger_attrs {
 	bool		clear;
 	bool		ts_in_usecs;
 	bool		no_hitcount;
+	bool		percpu;
 	unsigned int	map_bits;
 
 	char		*assignment_str[TRACING_MAP_VARS_MAX];
@@ -1557,6 +1559,8 @@ parse_hist_trigger_attrs(struct trace_array *tr, char *trigger_str)
 			attrs->cont = true;
 		else if (strcmp(str, "clear") == 0)
 			attrs->clear = true;
+		else if (strcmp(str, "percpu") == 0)
+			attrs->percpu = true;
 		else {
 			ret = parse_action(str, attrs);
 			if (ret)
@@ -5123,6 +5127,12 @@ create_hist_data(unsigned int map_bits,
 		goto free;
 	}
 
+	if (attrs->percpu) {
+		ret = tracing_map_set_percpu(hist_data->map);
+		if (ret)
+			goto free;
+	}
+
 	ret = create_tracing_map_fields(hist_data);
 	if (ret)
 		goto free;
@@ -5586,7 +5596,7 @@ static void hist_trigger_show(struct seq_file *m,
 	track_data_snapshot_print(m, hist_data);
 
 	seq_printf(m, "\nTotals:\n    Hits: %llu\n    Entries: %u\n    Dropped: %llu\n",
-		   (u64)atomic64_read(&hist_data->map->hits),
+		   tracing_map_read_hits(hist_data->map),
 		   n_entries, (u64)atomic64_read(&hist_data->map->drops));
 }
 
@@ -5635,6 +5645,208 @@ const struct file_operations event_hist_fops = {
 	.release = tracing_single_release_file_tr,
 };
 
+/*
+ * The hist_raw file exports the same aggregates as the hist file,
+ * but as unsorted binary records described by struct
+ * trace_hist_raw_header, so that collectors can scrape them without
+ * the kernel sorting and formatting every entry.  The contents are
+ * snapshotted when the file is opened.
+ */
+struct hist_raw_buf {
+	void			*data;
+	size_t			size;
+};
+
+struct hist_raw_fill {
+	struct hist_trigger_data	*hist_data;
+	struct trace_hist_raw_header	*header;
+	void				*pos;
+	void				*end;
+};
+
+static bool hist_raw_val_exported(struct hist_trigger_data *hist_data,
+				  unsigned int i)
+{
+	unsigned long flags = hist_data->fields[i]->flags;
+
+	return !(flags & (HIST_FIELD_FL_VAR | HIST_FIELD_FL_EXPR));
+}
+
+static unsigned int hist_raw_entry_size(struct hist_trigger_data *hist_data,
+					unsigned int *n_vals)
+{
+	unsigned int i;
+
+	*n_vals = 1;
+	for (i = 1; i < hist_data->n_vals; i++)
+		if (hist_raw_val_exported(hist_data, i))
+			(*n_vals)++;
+
+	return ALIGN(hist_data->key_size, sizeof(u64)) + *n_vals * sizeof(u64);
+}
+
+static int hist_raw_fill_elt(struct tracing_map_elt *elt, void *data)
+{
+	struct hist_raw_fill *fill = data;
+	struct hist_trigger_data *hist_data = fill->hist_data;
+	struct trace_hist_raw_header *header = fill->header;
+	unsigned int i;
+	u64 *vals;
+
+	/* Keys inserted after the buffer was sized are left out */
+	if (fill->pos + header->entry_size > fill->end)
+		return -ENOSPC;
+
+	memcpy(fill->pos, elt->key, header->key_size);
+
+	vals = fill->pos + ALIGN(header->key_size, sizeof(u64));
+	*vals++ = tracing_map_read_sum(elt, HITCOUNT_IDX);
+	for (i = 1; i < hist_data->n_vals; i++)
+		if (hist_raw_val_exported(hist_data, i))
+			*vals++ = tracing_map_read_sum(elt, i);
+
+	header->n_entries++;
+	fill->pos += header->entry_size;
+
+	return 0;
+}
+
+static void *hist_raw_fill_table(void *pos, struct hist_trigger_data *hist_data,
+				 unsigned int max_entries)
+{
+	struct trace_hist_raw_header *header = pos;
+	struct hist_raw_fill fill;
+	unsigned int n_vals;
+
+	header->magic = TRACE_HIST_RAW_MAGIC;
+	header->version = TRACE_HIST_RAW_VERSION;
+	header->header_size = sizeof(*header);
+	header->key_size = hist_data->key_size;
+	header->entry_size = hist_raw_entry_size(hist_data, &n_vals);
+	header->n_vals = n_vals;
+	header->hits = tracing_map_read_hits(hist_data->map);
+	header->drops = (u64)atomic64_read(&hist_data->map->drops);
+
+	fill.hist_data = hist_data;
+	fill.header = header;
+	fill.pos = pos + sizeof(*header);
+	fill.end = fill.pos + (size_t)max_entries * header->entry_size;
+
+	tracing_map_for_each_elt(hist_data->map, hist_raw_fill_elt, &fill);
+
+	return fill.pos;
+}
+
+static unsigned int hist_raw_max_entries(struct hist_trigger_data *hist_data)
+{
+	struct tracing_map *map = hist_data->map;
+
+	return min_t(unsigned int, atomic_read(&map->next_elt), map->max_elts);
+}
+
+static int hist_raw_snapshot(struct trace_event_file *event_file,
+			     struct hist_raw_buf *buf)
+{
+	struct hist_trigger_data *hist_data;
+	struct event_trigger_data *data;
+	unsigned int n_vals;
+	size_t size = 0;
+	void *pos;
+
+	list_for_each_entry(data, &event_file->triggers, list) {
+		if (data->cmd_ops->trigger_type != ETT_EVENT_HIST)
+			continue;
+		hist_data = data->private_data;
+		size += sizeof(struct trace_hist_raw_header) +
+			(size_t)hist_raw_max_entries(hist_data) *
+			hist_raw_entry_size(hist_data, &n_vals);
+	}
+
+	if (!size)
+		return 0;
+
+	buf->data = kvzalloc(size, GFP_KERNEL);
+	if (!buf->data)
+		return -ENOMEM;
+
+	pos = buf->data;
+	list_for_each_entry(data, &event_file->triggers, list) {
+		if (data->cmd_ops->trigger_type != ETT_EVENT_HIST)
+			continue;
+		hist_data = data->private_data;
+		pos = hist_raw_fill_table(pos, hist_data,
+					  hist_raw_max_entries(hist_data));
+	}
+	buf->size = pos - buf->data;
+
+	return 0;
+}
+
+static int event_hist_raw_open(struct inode *inode, struct file *file)
+{
+	struct trace_event_file *event_file;
+	struct hist_raw_buf *buf;
+	int ret;
+
+	ret = tracing_open_file_tr(inode, file);
+	if (ret)
+		return ret;
+
+	buf = kzalloc(sizeof(*buf), GFP_KERNEL);
+	if (!buf) {
+		ret = -ENOMEM;
+		goto out_release;
+	}
+
+	mutex_lock(&event_mutex);
+
+	event_file = event_file_file(file);
+	if (unlikely(!event_file))
+		ret = -ENODEV;
+	else
+		ret = hist_raw_snapshot(event_file, buf);
+
+	mutex_unlock(&event_mutex);
+
+	if (ret) {
+		kfree(buf);
+		goto out_release;
+	}
+
+	file->private_data = buf;
+
+	return 0;
+ out_release:
+	tracing_release_file_tr(inode, file);
+
+	return ret;
+}
+
+static ssize_t event_hist_raw_read(struct file *file, char __user *ubuf,
+				   size_t cnt, loff_t *ppos)
+{
+	struct hist_raw_buf *buf = file->private_data;
+
+	return simple_read_from_buffer(ubuf, cnt, ppos, buf->data, buf->size);
+}
+
+static int event_hist_raw_release(struct inode *inode, struct file *file)
+{
+	struct hist_raw_buf *buf = file->private_data;
+
+	kvfree(buf->data);
+	kfree(buf);
+
+	return tracing_release_file_tr(inode, file);
+}
+
+const struct file_operations event_hist_raw_fops = {
+	.open = event_hist_raw_open,
+	.read = event_hist_raw_read,
+	.llseek = default_llseek,
+	.release = event_hist_raw_release,
+};
+
 #ifdef CONFIG_HIST_TRIGGERS_DEBUG
 static void hist_field_debug_show_flags(struct seq_file *m,
 					unsigned long flags)
@@ -6050,6 +6262,8 @@ static int event_hist_trigger_print(struct seq_file *m,
 		seq_printf(m, ":clock=%s", hist_data->attrs->clock);
 	if (hist_data->attrs->no_hitcount)
 		seq_puts(m, ":nohitcount");
+	if (hist_data->attrs->percpu)
+		seq_puts(m, ":percpu");
 
 	print_actions_spec(m, hist_data);
 
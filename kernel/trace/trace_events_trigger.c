@@ -86,10 +86,38 @@ event_triggers_call(struct trace_event_file *file,
 }
 EXPORT_SYMBOL_GPL(event_triggers_call);
 
+/*
+ * Count the hits of a sampled event on this CPU and tell whether this
+ * one is to be dropped.  The counting is per CPU so sampling doesn't
+ * add a shared cacheline write to every hit.
+ */
+static bool trace_event_sampled_out(struct trace_event_file *file)
+{
+	unsigned int period = READ_ONCE(file->sample_period);
+
+	/* Pairs with the smp_wmb() in event_sample_write() */
+	smp_rmb();
+
+	if (this_cpu_inc_return(file->sample->count) < period) {
+		this_cpu_inc(file->sample->sampled_out);
+		return true;
+	}
+
+	this_cpu_write(file->sample->count, 0);
+	return false;
+}
+
 bool __trace_trigger_soft_disabled(struct trace_event_file *file)
 {
 	unsigned long eflags = file->flags;
 
+	if (eflags & EVENT_FILE_FL_SAMPLED) {
+		if (trace_event_sampled_out(file))
+			return true;
+		if (eflags & EVENT_FILE_FL_TRIGGER_COND)
+			return false;
+	}
+
 	if (eflags & EVENT_FILE_FL_TRIGGER_MODE)
 		event_triggers_call(file, NULL, NULL, NULL);
 	if (eflags & EVENT_FILE_FL_SOFT_DISABLED)
@@ -16,6 +16,7 @@
 #include <linux/slab.h>
 #include <linux/sort.h>
 #include <linux/kmemleak.h>
+#include <linux/percpu.h>
 
 #include "tracing_map.h"
 #include "trace.h"
@@ -35,10 +36,27 @@
  * Add n to sum i associated with the specified tracing_map_elt
  * instance.  The index i is the index returned by the call to
  * tracing_map_add_sum_field() when the tracing map was set up.
+ *
+ * If the map is in percpu mode, only the current CPU's copy of the
+ * sum is updated.
  */
 void tracing_map_update_sum(struct tracing_map_elt *elt, unsigned int i, u64 n)
 {
-	atomic64_add(n, &elt->fields[i].sum);
+	if (elt->percpu_sums)
+		this_cpu_add(elt->percpu_sums[i], n);
+	else
+		atomic64_add(n, &elt->fields[i].sum);
+}
+
+static u64 tracing_map_fold_sum(struct tracing_map_elt *elt, unsigned int i)
+{
+	u64 sum = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		sum += per_cpu_ptr(elt->percpu_sums, cpu)[i];
+
+	return sum;
 }
 
 /**
@@ -51,13 +69,49 @@ void tracing_map_update_sum(struct tracing_map_elt *elt, unsigned int i, u64 n)
  * call to tracing_map_add_sum_field() when the tracing map was set
  * up.
  *
+ * If the map is in percpu mode, the per-CPU copies of the sum are
+ * added together.
+ *
  * Return: The sum associated with field i for elt.
  */
 u64 tracing_map_read_sum(struct tracing_map_elt *elt, unsigned int i)
 {
+	if (elt->percpu_sums)
+		return tracing_map_fold_sum(elt, i);
+
 	return (u64)atomic64_read(&elt->fields[i].sum);
 }
 
+/**
+ * tracing_map_read_hits - Return the number of hits of a tracing_map
+ * @map: The tracing_map
+ *
+ * Retrieve the 'hits' value of the map, adding up the per-CPU
+ * counters if the map is in percpu mode.
+ *
+ * Return: The number of successful insertions and lookups.
+ */
+u64 tracing_map_read_hits(struct tracing_map *map)
+{
+	u64 hits = (u64)atomic64_read(&map->hits);
+	int cpu;
+
+	if (map->percpu_hits) {
+		for_each_possible_cpu(cpu)
+			hits += *per_cpu_ptr(map->percpu_hits, cpu);
+	}
+
+	return hits;
+}
+
+static inline void tracing_map_inc_hits(struct tracing_map *map)
+{
+	if (map->percpu_hits)
+		this_cpu_inc(*map->percpu_hits);
+	else
+		atomic64_inc(&map->hits);
+}
+
 /**
  * tracing_map_set_var - Assign a tracing_map_elt's variable field
  * @elt: The tracing_map_elt
@@ -358,11 +412,18 @@ static struct tracing_map_array *tracing_map_array_alloc(unsigned int n_elts,
 static void tracing_map_elt_clear(struct tracing_map_elt *elt)
 {
 	unsigned i;
+	int cpu;
 
 	for (i = 0; i < elt->map->n_fields; i++)
 		if (elt->fields[i].cmp_fn == tracing_map_cmp_atomic64)
 			atomic64_set(&elt->fields[i].sum, 0);
 
+	if (elt->percpu_sums) {
+		for_each_possible_cpu(cpu)
+			memset(per_cpu_ptr(elt->percpu_sums, cpu), 0,
+			       elt->map->n_fields * sizeof(u64));
+	}
+
 	for (i = 0; i < elt->map->n_vars; i++) {
 		atomic64_set(&elt->vars[i], 0);
 		elt->var_set[i] = false;
@@ -394,6 +455,7 @@ static void tracing_map_elt_free(struct tracing_map_elt *elt)
 	if (elt->map->ops && elt->map->ops->elt_free)
 		elt->map->ops->elt_free(elt);
 	kfree(elt->fields);
+	free_percpu(elt->percpu_sums);
 	kfree(elt->vars);
 	kfree(elt->var_set);
 	kfree(elt->key);
@@ -423,6 +485,15 @@ static struct tracing_map_elt *tracing_map_elt_alloc(struct tracing_map *map)
 		goto free;
 	}
 
+	if (map->percpu) {
+		elt->percpu_sums = __alloc_percpu(map->n_fields * sizeof(u64),
+						  __alignof__(u64));
+		if (!elt->percpu_sums) {
+			err = -ENOMEM;
+			goto free;
+		}
+	}
+
 	elt->vars = kcalloc(map->n_vars, sizeof(*elt->vars), GFP_KERNEL);
 	if (!elt->vars) {
 		err = -ENOMEM;
@@ -449,12 +520,53 @@ static struct tracing_map_elt *tracing_map_elt_alloc(struct tracing_map *map)
 	return ERR_PTR(err);
 }
 
+/*
+ * In percpu mode, each CPU grabs elt_batch elts at a time from the
+ * shared pool and hands them out locally.  Interrupts are disabled
+ * around the per-CPU cache since insertions can nest from interrupt
+ * context on the same CPU.  That does not keep out NMIs, so an
+ * insertion from NMI context never touches the cache and claims its
+ * elt straight from the shared pool instead.
+ */
+static int get_free_elt_idx_percpu(struct tracing_map *map)
+{
+	struct tracing_map_elt_cache *cache;
+	unsigned long flags;
+	int idx, old, new;
+
+	local_irq_save(flags);
+
+	cache = this_cpu_ptr(map->elt_cache);
+	if (cache->next == cache->end) {
+		old = atomic_read(&map->next_elt);
+		do {
+			if (old >= map->max_elts) {
+				idx = map->max_elts;
+				goto out;
+			}
+			new = min_t(int, old + map->elt_batch, map->max_elts);
+		} while (!atomic_try_cmpxchg(&map->next_elt, &old, new));
+
+		cache->next = old;
+		cache->end = new;
+	}
+
+	idx = cache->next++;
+ out:
+	local_irq_restore(flags);
+
+	return idx;
+}
+
 static struct tracing_map_elt *get_free_elt(struct tracing_map *map)
 {
 	struct tracing_map_elt *elt = NULL;
 	int idx;
 
-	idx = atomic_fetch_add_unless(&map->next_elt, 1, map->max_elts);
+	if (map->elt_cache && !in_nmi())
+		idx = get_free_elt_idx_percpu(map);
+	else
+		idx = atomic_fetch_add_unless(&map->next_elt, 1, map->max_elts);
 	if (idx < map->max_elts) {
 		elt = *(TRACING_MAP_ELT(map->elts, idx));
 		if (map->ops && map->ops->elt_init)
@@ -535,7 +647,7 @@ __tracing_map_insert(struct tracing_map *map, void *key, bool lookup_only)
 			if (val &&
 			    keys_match(key, val->key, map->key_size)) {
 				if (!lookup_only)
-					atomic64_inc(&map->hits);
+					tracing_map_inc_hits(map);
 				return val;
 			} else if (unlikely(!val)) {
 				/*
@@ -580,7 +692,7 @@ __tracing_map_insert(struct tracing_map *map, void *key, bool lookup_only)
 				 */
 				smp_wmb();
 				WRITE_ONCE(entry->val, elt);
-				atomic64_inc(&map->hits);
+				tracing_map_inc_hits(map);
 
 				return entry->val;
 			} else {
@@ -680,6 +792,8 @@ void tracing_map_destroy(struct tracing_map *map)
 
 	tracing_map_free_elts(map);
 
+	free_percpu(map->elt_cache);
+	free_percpu(map->percpu_hits);
 	tracing_map_array_free(map->map);
 	kfree(map);
 }
@@ -698,11 +812,20 @@ void tracing_map_destroy(struct tracing_map *map)
 void tracing_map_clear(struct tracing_map *map)
 {
 	unsigned int i;
+	int cpu;
 
 	atomic_set(&map->next_elt, 0);
 	atomic64_set(&map->hits, 0);
 	atomic64_set(&map->drops, 0);
 
+	if (map->percpu) {
+		for_each_possible_cpu(cpu) {
+			*per_cpu_ptr(map->percpu_hits, cpu) = 0;
+			per_cpu_ptr(map->elt_cache, cpu)->next = 0;
+			per_cpu_ptr(map->elt_cache, cpu)->end = 0;
+		}
+	}
+
 	tracing_map_array_clear(map->map);
 
 	for (i = 0; i < map->max_elts; i++)
@@ -807,6 +930,53 @@ struct tracing_map *tracing_map_create(unsigned int map_bits,
 	goto out;
 }
 
+/**
+ * tracing_map_set_percpu - Switch a tracing_map to percpu mode
+ * @map: The tracing_map
+ *
+ * Makes the sums, the 'hits' counter and the free element pool of
+ * the map per-CPU, trading memory and read-side cost for
+ * update-side scalability: tracing_map_update_sum() and
+ * tracing_map_insert() no longer write to cachelines shared with
+ * other CPUs once a key exists.  The per-CPU values are merged
+ * whenever the map is read.
+ *
+ * Must be called after tracing_map_create() and before
+ * tracing_map_init().
+ *
+ * Return: 0 if successful, -ENOMEM otherwise.
+ */
+int tracing_map_set_percpu(struct tracing_map *map)
+{
+	if (WARN_ON_ONCE(map->elts))
+		return -EBUSY;
+
+	if (map->percpu)
+		return 0;
+
+	map->elt_cache = alloc_percpu(struct tracing_map_elt_cache);
+	if (!map->elt_cache)
+		return -ENOMEM;
+
+	map->percpu_hits = alloc_percpu(u64);
+	if (!map->percpu_hits) {
+		free_percpu(map->elt_cache);
+		map->elt_cache = NULL;
+		return -ENOMEM;
+	}
+
+	/*
+	 * Keep the elts that can be stranded in other CPUs' caches to a
+	 * small fraction of the pool.
+	 */
+	map->elt_batch = clamp_t(unsigned int,
+				 map->max_elts / (8 * num_possible_cpus()),
+				 1, 32);
+	map->percpu = true;
+
+	return 0;
+}
+
 /**
  * tracing_map_init - Allocate and clear a map's tracing_map_elts
  * @map: The tracing_map to initialize
@@ -915,6 +1085,20 @@ static int cmp_entries_key(const void *A, const void *B)
 	return ret;
 }
 
+/*
+ * The sort comparison functions work on the sum fields directly, so
+ * in percpu mode snapshot the merged per-CPU sums into them first.
+ */
+static void tracing_map_elt_fold_sums(struct tracing_map_elt *elt)
+{
+	unsigned int i;
+
+	for (i = 0; i < elt->map->n_fields; i++)
+		if (elt->fields[i].cmp_fn == tracing_map_cmp_atomic64)
+			atomic64_set(&elt->fields[i].sum,
+				     tracing_map_fold_sum(elt, i));
+}
+
 static void destroy_sort_entry(struct tracing_map_sort_entry *entry)
 {
 	if (!entry)
@@ -1042,6 +1226,45 @@ static void sort_secondary(struct tracing_map *map,
 	}
 }
 
+/**
+ * tracing_map_for_each_elt - Iterate over the current set of tracing_map_elts
+ * @map: The tracing_map
+ * @fn: The function to call for each tracing_map_elt
+ * @data: Client data passed to @fn
+ *
+ * Calls @fn for every tracing_map_elt currently inserted in the map,
+ * in hash table order.  Unlike tracing_map_sort_entries(), nothing is
+ * allocated or sorted, which makes this suitable for clients that
+ * only need to dump the map contents.  The iteration stops early if
+ * @fn returns non-zero.
+ *
+ * Return: 0 if all elements were visited, or the first non-zero value
+ * returned by @fn.
+ */
+int tracing_map_for_each_elt(struct tracing_map *map,
+			     int (*fn)(struct tracing_map_elt *elt, void *data),
+			     void *data)
+{
+	struct tracing_map_entry *entry;
+	struct tracing_map_elt *elt;
+	unsigned int i;
+	int ret;
+
+	for (i = 0; i < map->map_size; i++) {
+		entry = TRACING_MAP_ENTRY(map->map, i);
+
+		elt = READ_ONCE(entry->val);
+		if (!entry->key || !elt)
+			continue;
+
+		ret = fn(elt, data);
+		if (ret)
+			return ret;
+	}
+
+	return 0;
+}
+
 /**
  * tracing_map_sort_entries - Sort the current set of tracing_map_elts in a map
  * @map: The tracing_map
@@ -1094,6 +1317,9 @@ int tracing_map_sort_entries(struct tracing_map *map,
 			ret = -ENOMEM;
 			goto free;
 		}
+
+		if (map->percpu)
+			tracing_map_elt_fold_sums(entry->val);
 	}
 
 	if (n_entries == 0) {
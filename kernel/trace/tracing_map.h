@@ -95,6 +95,18 @@ typedef int (*tracing_map_cmp_fn_t) (void *val_a, void *val_b);
  * tracing_map_elts is allocated as a single block and is stored in
  * the elts field of struct tracing_map.
  *
+ * A map can optionally be switched into percpu mode by calling
+ * tracing_map_set_percpu() before tracing_map_init().  In that mode
+ * each tracing_map_elt carries a per-CPU copy of its sums, which
+ * tracing_map_update_sum() updates without any shared atomics, and
+ * the 'hits' counter and the pool of free tracing_map_elts are
+ * likewise split per CPU.  The per-CPU copies are only merged when
+ * the map is read, i.e. by tracing_map_read_sum(),
+ * tracing_map_read_hits() and tracing_map_sort_entries().  The
+ * tracing_map_entry array itself stays shared: once a key has been
+ * inserted it is only ever read on the insertion path, so it doesn't
+ * bounce between CPUs the way the sums do.
+ *
  * There is also a set of structures used for sorting that might
  * benefit from some minimal explanation.
  *
@@ -138,6 +150,7 @@ struct tracing_map_field {
 struct tracing_map_elt {
 	struct tracing_map		*map;
 	struct tracing_map_field	*fields;
+	u64 __percpu			*percpu_sums;
 	atomic64_t			*vars;
 	bool				*var_set;
 	void				*key;
@@ -180,6 +193,16 @@ struct tracing_map_array {
 #define TRACING_MAP_ELT(array, idx)					\
 	((struct tracing_map_elt **)TRACING_MAP_ARRAY_ELT(array, idx))
 
+/*
+ * Per-CPU range of pre-allocated elts handed out by get_free_elt()
+ * when the map is in percpu mode, so that CPUs inserting new keys
+ * only touch the shared next_elt counter once per batch.
+ */
+struct tracing_map_elt_cache {
+	unsigned int			next;
+	unsigned int			end;
+};
+
 struct tracing_map {
 	unsigned int			key_size;
 	unsigned int			map_bits;
@@ -198,6 +221,10 @@ struct tracing_map {
 	unsigned int			n_vars;
 	atomic64_t			hits;
 	atomic64_t			drops;
+	bool				percpu;
+	unsigned int			elt_batch;
+	struct tracing_map_elt_cache __percpu *elt_cache;
+	u64 __percpu			*percpu_hits;
 };
 
 /**
@@ -242,6 +269,7 @@ tracing_map_create(unsigned int map_bits,
 		   unsigned int key_size,
 		   const struct tracing_map_ops *ops,
 		   void *private_data);
+extern int tracing_map_set_percpu(struct tracing_map *map);
 extern int tracing_map_init(struct tracing_map *map);
 
 extern int tracing_map_add_sum_field(struct tracing_map *map);
@@ -271,6 +299,7 @@ extern bool tracing_map_var_set(struct tracing_map_elt *elt, unsigned int i);
 extern u64 tracing_map_read_sum(struct tracing_map_elt *elt, unsigned int i);
 extern u64 tracing_map_read_var(struct tracing_map_elt *elt, unsigned int i);
 extern u64 tracing_map_read_var_once(struct tracing_map_elt *elt, unsigned int i);
+extern u64 tracing_map_read_hits(struct tracing_map *map);
 
 extern int
 tracing_map_sort_entries(struct tracing_map *map,
@@ -278,6 +307,11 @@ tracing_map_sort_entries(struct tracing_map *map,
 			 unsigned int n_sort_keys,
 			 struct tracing_map_sort_entry ***sort_entries);
 
+extern int
+tracing_map_for_each_elt(struct tracing_map *map,
+			 int (*fn)(struct tracing_map_elt *elt, void *data),
+			 void *data);
+
 extern void
 tracing_map_destroy_sort_entries(struct tracing_map_sort_entry **entries,
 				 unsigned int n_entries);
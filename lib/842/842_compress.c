@@ -136,8 +136,13 @@ struct sw842_param {
 	 ? find_index(p, b, n)			\
 	 : (p)->index##b[n] >= 0)
 
+/* repetitive input (zero pages, fill patterns) very often rewrites a node
+ * with the data it already holds; leave such nodes hashed where they are
+ */
 #define replace_hash(p, b, i, d)	do {				\
 	struct sw842_hlist_node##b *_n = &(p)->node##b[(i)+(d)];	\
+	if (_n->data == (p)->data##b[d] && !hlist_unhashed(&_n->node))	\
+		break;							\
 	hash_del(&_n->node);						\
 	_n->data = (p)->data##b[d];					\
 	pr_debug("add hash index%x %x pos %x data %lx\n", b,		\
@@ -5,6 +5,9 @@
 
 #include <linux/dim.h>
 
+#define CREATE_TRACE_POINTS
+#include <trace/events/dim.h>
+
 bool dim_on_top(struct dim *dim)
 {
 	switch (dim->tune_state) {
@@ -5,6 +5,7 @@
 
 #include <linux/dim.h>
 #include <linux/rtnetlink.h>
+#include <trace/events/dim.h>
 
 /*
  * Net DIM profiles:
@@ -344,6 +345,8 @@ static bool net_dim_decision(struct dim_stats *curr_stats, struct dim *dim)
 	    dim->tune_state != DIM_PARKING_ON_TOP)
 		dim->prev_stats = *curr_stats;
 
+	trace_dim_decision(dim, curr_stats, prev_ix);
+
 	return dim->profile_ix != prev_ix;
 }
 
@@ -4,6 +4,7 @@
  */
 
 #include <linux/dim.h>
+#include <trace/events/dim.h>
 
 static int rdma_dim_step(struct dim *dim)
 {
@@ -70,6 +71,8 @@ static bool rdma_dim_decision(struct dim_stats *curr_stats, struct dim *dim)
 
 	dim->prev_stats = *curr_stats;
 
+	trace_dim_decision(dim, curr_stats, prev_ix);
+
 	return dim->profile_ix != prev_ix;
 }
 
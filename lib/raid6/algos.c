@@ -131,6 +131,32 @@ const struct raid6_recov_calls *const raid6_recov_algos[] = {
 #define RAID6_TEST_DISKS	8
 #define RAID6_TEST_DISKS_ORDER	3
 
+#ifdef __KERNEL__
+/*
+ * Skip the boot-time gen() benchmark and use the named algorithm, e.g. a
+ * result recorded from an earlier boot: raid6_pq.algo=avx512x4
+ */
+static char *raid6_algo_name;
+module_param_named(algo, raid6_algo_name, charp, 0444);
+MODULE_PARM_DESC(algo, "Use this gen() algorithm instead of benchmarking");
+
+static const struct raid6_calls *raid6_find_gen(const char *name)
+{
+	const struct raid6_calls *const *algo;
+
+	for (algo = raid6_algos; *algo; algo++) {
+		if (strcmp((*algo)->name, name))
+			continue;
+		if ((*algo)->valid && !(*algo)->valid())
+			break;
+		return *algo;
+	}
+
+	pr_warn("raid6: algorithm %s not available, benchmarking\n", name);
+	return NULL;
+}
+#endif
+
 static inline const struct raid6_recov_calls *raid6_choose_recov(void)
 {
 	const struct raid6_recov_calls *const *algo;
@@ -160,6 +186,18 @@ static inline const struct raid6_calls *raid6_choose_gen(
 	const struct raid6_calls *const *algo;
 	const struct raid6_calls *best;
 
+#ifdef __KERNEL__
+	if (raid6_algo_name && *raid6_algo_name) {
+		best = raid6_find_gen(raid6_algo_name);
+		if (best) {
+			raid6_call = *best;
+			pr_info("raid6: using requested algorithm %s\n",
+				best->name);
+			return best;
+		}
+	}
+#endif
+
 	for (bestgenperf = 0, best = NULL, algo = raid6_algos; *algo; algo++) {
 		if (!best || (*algo)->priority >= best->priority) {
 			if ((*algo)->valid && !(*algo)->valid())
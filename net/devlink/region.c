@@ -789,33 +789,44 @@ typedef int devlink_chunk_fill_t(void *cb_priv, u8 *chunk, u32 chunk_size,
 				 u64 curr_offset,
 				 struct netlink_ext_ack *extack);
 
+/* A NULL @cb means @cb_priv is the region contents (a snapshot), which are
+ * put into the message directly instead of through a bounce buffer.
+ */
 static int
 devlink_nl_region_read_fill(struct sk_buff *skb, devlink_chunk_fill_t *cb,
 			    void *cb_priv, u64 start_offset, u64 end_offset,
 			    u64 *new_offset, struct netlink_ext_ack *extack)
 {
 	u64 curr_offset = start_offset;
+	u8 *data = NULL;
 	int err = 0;
-	u8 *data;
 
 	/* Allocate and re-use a single buffer */
-	data = kmalloc(DEVLINK_REGION_READ_CHUNK_SIZE, GFP_KERNEL);
-	if (!data)
-		return -ENOMEM;
+	if (cb) {
+		data = kmalloc(DEVLINK_REGION_READ_CHUNK_SIZE, GFP_KERNEL);
+		if (!data)
+			return -ENOMEM;
+	}
 
 	*new_offset = start_offset;
 
 	while (curr_offset < end_offset) {
 		u32 data_size;
+		u8 *chunk;
 
 		data_size = min_t(u32, end_offset - curr_offset,
 				  DEVLINK_REGION_READ_CHUNK_SIZE);
 
-		err = cb(cb_priv, data, data_size, curr_offset, extack);
-		if (err)
-			break;
+		if (cb) {
+			err = cb(cb_priv, data, data_size, curr_offset, extack);
+			if (err)
+				break;
+			chunk = data;
+		} else {
+			chunk = (u8 *)cb_priv + curr_offset;
+		}
 
-		err = devlink_nl_cmd_region_read_chunk_fill(skb, data, data_size, curr_offset);
+		err = devlink_nl_cmd_region_read_chunk_fill(skb, chunk, data_size, curr_offset);
 		if (err)
 			break;
 
@@ -828,18 +839,6 @@ devlink_nl_region_read_fill(struct sk_buff *skb, devlink_chunk_fill_t *cb,
 	return err;
 }
 
-static int
-devlink_region_snapshot_fill(void *cb_priv, u8 *chunk, u32 chunk_size,
-			     u64 curr_offset,
-			     struct netlink_ext_ack __always_unused *extack)
-{
-	struct devlink_snapshot *snapshot = cb_priv;
-
-	memcpy(chunk, &snapshot->data[curr_offset], chunk_size);
-
-	return 0;
-}
-
 static int
 devlink_region_port_direct_fill(void *cb_priv, u8 *chunk, u32 chunk_size,
 				u64 curr_offset, struct netlink_ext_ack *extack)
@@ -951,8 +950,8 @@ int devlink_nl_region_read_dumpit(struct sk_buff *skb,
 			err = -EINVAL;
 			goto out_unlock;
 		}
-		region_cb = &devlink_region_snapshot_fill;
-		region_cb_priv = snapshot;
+		region_cb = NULL;
+		region_cb_priv = snapshot->data;
 	}
 
 	if (attrs[DEVLINK_ATTR_REGION_CHUNK_ADDR] &&
@@ -36,9 +36,12 @@ static inline struct net_device *dsa_conduit_find_user(struct net_device *dev,
 	struct dsa_switch_tree *dst = cpu_dp->dst;
 	struct dsa_port *dp;
 
+	/* Called for every received frame: test the port's own fields
+	 * before dereferencing its switch.
+	 */
 	list_for_each_entry(dp, &dst->ports, list)
-		if (dp->ds->index == device && dp->index == port &&
-		    dp->type == DSA_PORT_TYPE_USER)
+		if (dp->index == port && dp->type == DSA_PORT_TYPE_USER &&
+		    dp->ds->index == device)
 			return dp->user;
 
 	return NULL;
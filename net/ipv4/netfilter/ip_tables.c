@@ -21,6 +21,7 @@
 #include <linux/proc_fs.h>
 #include <linux/err.h>
 #include <linux/cpumask.h>
+#include <linux/prefetch.h>
 
 #include <linux/netfilter/x_tables.h>
 #include <linux/netfilter_ipv4/ip_tables.h>
@@ -280,6 +281,10 @@ ipt_do_table(void *priv,
 		struct xt_counters *counter;
 
 		WARN_ON(!e);
+		/* Most rules fail on the IP header alone; entries are
+		 * variable sized, so start loading the next header now.
+		 */
+		prefetch(ipt_next_entry(e));
 		if (!ip_packet_match(ip, indev, outdev,
 		    &e->ip, acpar.fragoff)) {
  no_match:
@@ -1340,9 +1340,10 @@ struct ieee80211_local {
 	struct codel_vars *cvars;
 	struct codel_params cparams;
 
-	/* protects active_txqs and txqi->schedule_order */
+	/* protects active_txqs, active_txqs_num and txqi->schedule_order */
 	spinlock_t active_txq_lock[IEEE80211_NUM_ACS];
 	struct list_head active_txqs[IEEE80211_NUM_ACS];
+	unsigned int active_txqs_num[IEEE80211_NUM_ACS];
 	u16 schedule_round[IEEE80211_NUM_ACS];
 
 	/* serializes ieee80211_handle_wake_tx_queue */
@@ -1814,6 +1815,17 @@ static inline bool txq_has_queue(struct ieee80211_txq *txq)
 	return !(skb_queue_empty(&txqi->frags) && !txqi->tin.backlog_packets);
 }
 
+/* Must be called with local->active_txq_lock[txqi->txq.ac] held */
+static inline void ieee80211_txq_unschedule(struct ieee80211_local *local,
+					    struct txq_info *txqi)
+{
+	if (list_empty(&txqi->schedule_order))
+		return;
+
+	list_del_init(&txqi->schedule_order);
+	local->active_txqs_num[txqi->txq.ac]--;
+}
+
 static inline bool
 ieee80211_have_rx_timestamp(struct ieee80211_rx_status *status)
 {
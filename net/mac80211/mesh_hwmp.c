@@ -994,16 +994,9 @@ static void mesh_queue_preq(struct mesh_path *mpath, u8 flags)
 	struct ieee80211_if_mesh *ifmsh = &sdata->u.mesh;
 	struct mesh_preq_queue *preq_node;
 
-	preq_node = kmalloc(sizeof(struct mesh_preq_queue), GFP_ATOMIC);
-	if (!preq_node) {
-		mhwmp_dbg(sdata, "could not allocate PREQ node\n");
-		return;
-	}
-
 	spin_lock_bh(&ifmsh->mesh_preq_queue_lock);
 	if (ifmsh->preq_queue_len == MAX_PREQ_QUEUE_LEN) {
 		spin_unlock_bh(&ifmsh->mesh_preq_queue_lock);
-		kfree(preq_node);
 		if (printk_ratelimit())
 			mhwmp_dbg(sdata, "PREQ node queue full\n");
 		return;
@@ -1013,7 +1006,17 @@ static void mesh_queue_preq(struct mesh_path *mpath, u8 flags)
 	if (mpath->flags & MESH_PATH_REQ_QUEUED) {
 		spin_unlock(&mpath->state_lock);
 		spin_unlock_bh(&ifmsh->mesh_preq_queue_lock);
-		kfree(preq_node);
+		return;
+	}
+
+	/* Only allocate once the request is known not to coalesce with a
+	 * queued one; refreshes are attempted for every frame on the path.
+	 */
+	preq_node = kmalloc(sizeof(struct mesh_preq_queue), GFP_ATOMIC);
+	if (!preq_node) {
+		spin_unlock(&mpath->state_lock);
+		spin_unlock_bh(&ifmsh->mesh_preq_queue_lock);
+		mhwmp_dbg(sdata, "could not allocate PREQ node\n");
 		return;
 	}
 
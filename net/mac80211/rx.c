@@ -1593,8 +1593,7 @@ static void sta_ps_start(struct sta_info *sta)
 		struct txq_info *txqi = to_txq_info(txq);
 
 		spin_lock(&local->active_txq_lock[txq->ac]);
-		if (!list_empty(&txqi->schedule_order))
-			list_del_init(&txqi->schedule_order);
+		ieee80211_txq_unschedule(local, txqi);
 		spin_unlock(&local->active_txq_lock[txq->ac]);
 
 		if (txq_has_queue(txq))
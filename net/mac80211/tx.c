@@ -1553,7 +1553,7 @@ void ieee80211_txq_purge(struct ieee80211_local *local,
 	spin_unlock_bh(&fq->lock);
 
 	spin_lock_bh(&local->active_txq_lock[txqi->txq.ac]);
-	list_del_init(&txqi->schedule_order);
+	ieee80211_txq_unschedule(local, txqi);
 	spin_unlock_bh(&local->active_txq_lock[txqi->txq.ac]);
 }
 
@@ -4095,7 +4095,7 @@ struct ieee80211_txq *ieee80211_next_txq(struct ieee80211_hw *hw, u8 ac)
 	if (txqi->schedule_round == local->schedule_round[ac])
 		goto out;
 
-	list_del_init(&txqi->schedule_order);
+	ieee80211_txq_unschedule(local, txqi);
 	txqi->schedule_round = local->schedule_round[ac];
 	ret = &txqi->txq;
 
@@ -4133,6 +4133,7 @@ void __ieee80211_schedule_txq(struct ieee80211_hw *hw,
 		else
 			list_add_tail(&txqi->schedule_order,
 				      &local->active_txqs[txq->ac]);
+		local->active_txqs_num[txq->ac]++;
 		if (has_queue)
 			ieee80211_txq_set_active(txqi);
 	}
@@ -4179,16 +4180,12 @@ EXPORT_SYMBOL(ieee80211_txq_airtime_check);
 static bool
 ieee80211_txq_schedule_airtime_check(struct ieee80211_local *local, u8 ac)
 {
-	unsigned int num_txq = 0;
-	struct txq_info *txq;
+	unsigned int num_txq = local->active_txqs_num[ac];
 	u32 aql_limit;
 
 	if (!wiphy_ext_feature_isset(local->hw.wiphy, NL80211_EXT_FEATURE_AQL))
 		return true;
 
-	list_for_each_entry(txq, &local->active_txqs[ac], schedule_order)
-		num_txq++;
-
 	aql_limit = (num_txq - 1) * local->aql_txq_limit_low[ac] / 2 +
 		    local->aql_txq_limit_high[ac];
 
@@ -4240,8 +4237,7 @@ bool ieee80211_txq_may_transmit(struct ieee80211_hw *hw,
 
 	return false;
 out:
-	if (!list_empty(&txqi->schedule_order))
-		list_del_init(&txqi->schedule_order);
+	ieee80211_txq_unschedule(local, txqi);
 	spin_unlock_bh(&local->active_txq_lock[ac]);
 
 	return true;
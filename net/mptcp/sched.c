@@ -36,6 +36,77 @@ static struct mptcp_sched_ops mptcp_sched_default = {
 	.owner		= THIS_MODULE,
 };
 
+/* BLEST (BLocking ESTimation) on top of the default choice: when the default
+ * picks a subflow with a higher RTT than the fastest active one, estimate how
+ * much the fast subflow could send while a segment is in flight on the slow
+ * one.  If that would not fit in what is left of the MPTCP-level send window,
+ * queueing on the slow subflow would only make the receiver hold the fast
+ * subflow's data out of order, so use the fast subflow or wait for it instead.
+ */
+static int mptcp_sched_blest_get_subflow(struct mptcp_sock *msk,
+					 struct mptcp_sched_data *data)
+{
+	struct mptcp_subflow_context *subflow;
+	u32 rtt, slow_rtt, fast_rtt = U32_MAX;
+	struct sock *ssk, *fast = NULL;
+	const struct tcp_sock *tp;
+	u64 fast_bytes, wnd, inflight;
+	u32 ratio;
+
+	if (data->reinject)
+		return mptcp_sched_default_get_subflow(msk, data);
+
+	ssk = mptcp_subflow_get_send(msk);
+	if (!ssk)
+		return -EINVAL;
+
+	mptcp_for_each_subflow(msk, subflow) {
+		struct sock *s = mptcp_subflow_tcp_sock(subflow);
+
+		if (subflow->backup || subflow->request_bkup ||
+		    !mptcp_subflow_active(subflow))
+			continue;
+
+		rtt = READ_ONCE(tcp_sk(s)->srtt_us) >> 3;
+		if (rtt && rtt < fast_rtt) {
+			fast_rtt = rtt;
+			fast = s;
+		}
+	}
+
+	slow_rtt = READ_ONCE(tcp_sk(ssk)->srtt_us) >> 3;
+	if (!fast || fast == ssk || slow_rtt <= fast_rtt)
+		goto out;
+
+	/* X = MSS_f * (CWND_f + (RTT_s / RTT_f - 1) / 2) * RTT_s / RTT_f */
+	tp = tcp_sk(fast);
+	ratio = slow_rtt / fast_rtt;
+	fast_bytes = (u64)READ_ONCE(tp->mss_cache) *
+		     (tcp_snd_cwnd(tp) + (ratio - 1) / 2) * ratio;
+
+	tp = tcp_sk(ssk);
+	wnd = READ_ONCE(msk->wnd_end) - READ_ONCE(msk->snd_una);
+	inflight = (u64)(tcp_packets_in_flight(tp) + 1) *
+		   READ_ONCE(tp->mss_cache);
+	if (inflight >= wnd || fast_bytes > wnd - inflight) {
+		tp = tcp_sk(fast);
+		if (tcp_packets_in_flight(tp) >= tcp_snd_cwnd(tp) ||
+		    !sk_stream_memory_free(fast))
+			return -EINVAL;
+		ssk = fast;
+	}
+
+out:
+	mptcp_subflow_set_scheduled(mptcp_subflow_ctx(ssk), true);
+	return 0;
+}
+
+static struct mptcp_sched_ops mptcp_sched_blest = {
+	.get_subflow	= mptcp_sched_blest_get_subflow,
+	.name		= "blest",
+	.owner		= THIS_MODULE,
+};
+
 /* Must be called with rcu read lock held */
 struct mptcp_sched_ops *mptcp_sched_find(const char *name)
 {
@@ -90,7 +161,7 @@ int mptcp_register_scheduler(struct mptcp_sched_ops *sched)
 
 void mptcp_unregister_scheduler(struct mptcp_sched_ops *sched)
 {
-	if (sched == &mptcp_sched_default)
+	if (sched == &mptcp_sched_default || sched == &mptcp_sched_blest)
 		return;
 
 	spin_lock(&mptcp_sched_list_lock);
@@ -101,6 +172,7 @@ void mptcp_unregister_scheduler(struct mptcp_sched_ops *sched)
 void mptcp_sched_init(void)
 {
 	mptcp_register_scheduler(&mptcp_sched_default);
+	mptcp_register_scheduler(&mptcp_sched_blest);
 }
 
 int mptcp_init_sched(struct mptcp_sock *msk,
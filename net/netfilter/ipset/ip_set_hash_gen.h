@@ -7,6 +7,7 @@
 #include <linux/rcupdate.h>
 #include <linux/rcupdate_wait.h>
 #include <linux/jhash.h>
+#include <linux/prefetch.h>
 #include <linux/types.h>
 #include <linux/netfilter/nfnetlink.h>
 #include <linux/netfilter/ipset/ip_set.h>
@@ -1167,10 +1168,14 @@ mtype_test_cidrs(struct ip_set *set, struct mtype_elem *d,
 #if IPSET_NET_COUNT == 2
 	struct mtype_elem orig = *d;
 	int ret, i, j = 0, k;
+	u32 key, multi = 0;
 #else
+	struct mtype_elem next;
+	bool have_next = false;
 	int ret, i, j = 0;
+	u32 key, nkey = 0, multi = 0;
+	u8 ncidr;
 #endif
-	u32 key, multi = 0;
 
 	pr_debug("test by nets\n");
 	for (; j < NLEN && h->nets[j].cidr[0] && !multi; j++) {
@@ -1181,10 +1186,29 @@ mtype_test_cidrs(struct ip_set *set, struct mtype_elem *d,
 		     k++) {
 			mtype_data_netmask(d, NCIDR_GET(h->nets[k].cidr[1]),
 					   true);
+		key = HKEY(d, h->initval, t->htable_bits);
 #else
-		mtype_data_netmask(d, NCIDR_GET(h->nets[j].cidr[0]));
+		if (have_next) {
+			*d = next;
+			key = nkey;
+		} else {
+			mtype_data_netmask(d, NCIDR_GET(h->nets[j].cidr[0]));
+			key = HKEY(d, h->initval, t->htable_bits);
+		}
+		/* Prefixes are sorted longest first, so the next one can be
+		 * masked from this one.  Hash it now and start loading its
+		 * bucket slot while this bucket is being compared.  nets[]
+		 * may change under us, so read the next prefix only once.
+		 */
+		ncidr = j + 1 < NLEN ? READ_ONCE(h->nets[j + 1].cidr[0]) : 0;
+		have_next = ncidr;
+		if (have_next) {
+			next = *d;
+			mtype_data_netmask(&next, NCIDR_GET(ncidr));
+			nkey = HKEY(&next, h->initval, t->htable_bits);
+			prefetch(&hbucket(t, nkey));
+		}
 #endif
-		key = HKEY(d, h->initval, t->htable_bits);
 		n = rcu_dereference_bh(hbucket(t, key));
 		if (!n)
 			continue;
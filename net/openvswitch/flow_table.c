@@ -29,6 +29,7 @@
 #include <linux/icmp.h>
 #include <linux/icmpv6.h>
 #include <linux/rculist.h>
+#include <linux/prefetch.h>
 #include <linux/sort.h>
 #include <net/ip.h>
 #include <net/ipv6.h>
@@ -752,6 +753,7 @@ static struct sw_flow *flow_lookup(struct flow_table *tbl,
 	}
 
 	for (i = 0; i < ma->max; i++)  {
+		struct sw_flow_mask *next;
 
 		if (i == *index)
 			continue;
@@ -760,6 +762,16 @@ static struct sw_flow *flow_lookup(struct flow_table *tbl,
 		if (unlikely(!mask))
 			break;
 
+		/* Masks are allocated separately; with many of them each one is
+		 * usually a cache miss, so start loading the next one while
+		 * this one is being hashed and looked up.
+		 */
+		if (i + 1 < ma->max) {
+			next = rcu_dereference_ovsl(ma->masks[i + 1]);
+			if (next)
+				prefetch(&next->range);
+		}
+
 		flow = masked_flow_lookup(ti, key, mask, n_mask_hit);
 		if (flow) { /* Found */
 			*index = i;
@@ -260,7 +260,8 @@ static struct rds_ib_incoming *rds_ib_refill_one_inc(struct rds_ib_connection *i
 			rds_ib_stats_inc(s_ib_rx_alloc_limit);
 			return NULL;
 		}
-		ibinc = kmem_cache_alloc(rds_ib_incoming_slab, slab_mask);
+		ibinc = kmem_cache_alloc_node(rds_ib_incoming_slab, slab_mask,
+					      ibdev_to_node(ic->i_cm_id->device));
 		if (!ibinc) {
 			atomic_dec(&rds_ib_allocation);
 			return NULL;
@@ -276,6 +277,7 @@ static struct rds_ib_incoming *rds_ib_refill_one_inc(struct rds_ib_connection *i
 static struct rds_page_frag *rds_ib_refill_one_frag(struct rds_ib_connection *ic,
 						    gfp_t slab_mask, gfp_t page_mask)
 {
+	int node = ibdev_to_node(ic->i_cm_id->device);
 	struct rds_page_frag *frag;
 	struct list_head *cache_item;
 	int ret;
@@ -286,13 +288,16 @@ static struct rds_page_frag *rds_ib_refill_one_frag(struct rds_ib_connection *ic
 		atomic_sub(RDS_FRAG_SIZE / SZ_1K, &ic->i_cache_allocs);
 		rds_ib_stats_add(s_ib_recv_added_to_cache, RDS_FRAG_SIZE);
 	} else {
-		frag = kmem_cache_alloc(rds_ib_frag_slab, slab_mask);
+		/* The refill worker may run on any node; the HCA DMAs
+		 * into these pages, so keep them next to the device.
+		 */
+		frag = kmem_cache_alloc_node(rds_ib_frag_slab, slab_mask, node);
 		if (!frag)
 			return NULL;
 
 		sg_init_table(&frag->f_sg, 1);
 		ret = rds_page_remainder_alloc(&frag->f_sg,
-					       RDS_FRAG_SIZE, page_mask);
+					       RDS_FRAG_SIZE, page_mask, node);
 		if (ret) {
 			kmem_cache_free(rds_ib_frag_slab, frag);
 			return NULL;
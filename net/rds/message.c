@@ -436,7 +436,8 @@ int rds_message_copy_from_user(struct rds_message *rm, struct iov_iter *from,
 	while (iov_iter_count(from)) {
 		if (!sg_page(sg)) {
 			ret = rds_page_remainder_alloc(sg, iov_iter_count(from),
-						       GFP_HIGHUSER);
+						       GFP_HIGHUSER,
+						       NUMA_NO_NODE);
 			if (ret)
 				return ret;
 			rm->data.op_nents++;
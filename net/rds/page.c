@@ -51,12 +51,14 @@ DEFINE_PER_CPU_SHARED_ALIGNED(struct rds_page_remainder, rds_page_remainders);
  * @scat: Scatter list for message
  * @bytes: the number of bytes needed.
  * @gfp: the waiting behaviour of the allocation
+ * @node: preferred memory node for full-page allocations, or NUMA_NO_NODE
  *
  * @gfp is always ored with __GFP_HIGHMEM.  Callers must be prepared to
  * kmap the pages, etc.
  *
  * If @bytes is at least a full page then this just returns a page from
- * alloc_page().
+ * alloc_pages_node() on @node, or from alloc_page() following the task's
+ * mempolicy if @node is NUMA_NO_NODE.
  *
  * If @bytes is a partial page then this stores the unused region of the
  * page in a per-cpu structure.  Future partial-page allocations may be
@@ -66,7 +68,7 @@ DEFINE_PER_CPU_SHARED_ALIGNED(struct rds_page_remainder, rds_page_remainders);
  * reference until they are done with the region.
  */
 int rds_page_remainder_alloc(struct scatterlist *scat, unsigned long bytes,
-			     gfp_t gfp)
+			     gfp_t gfp, int node)
 {
 	struct rds_page_remainder *rem;
 	unsigned long flags;
@@ -77,7 +79,10 @@ int rds_page_remainder_alloc(struct scatterlist *scat, unsigned long bytes,
 
 	/* jump straight to allocation if we're trying for a huge page */
 	if (bytes >= PAGE_SIZE) {
-		page = alloc_page(gfp);
+		if (node == NUMA_NO_NODE)
+			page = alloc_page(gfp);
+		else
+			page = alloc_pages_node(node, gfp, 0);
 		if (!page) {
 			ret = -ENOMEM;
 		} else {
@@ -883,7 +883,7 @@ static inline int rds_message_verify_checksum(const struct rds_header *hdr)
 
 /* page.c */
 int rds_page_remainder_alloc(struct scatterlist *scat, unsigned long bytes,
-			     gfp_t gfp);
+			     gfp_t gfp, int node);
 void rds_page_exit(void);
 
 /* recv.c */
@@ -37,14 +37,20 @@ static void rxrpc_encap_err_rcv(struct sock *sk, struct sk_buff *skb, int err,
 }
 
 /*
- * Set or clear the Don't Fragment flag on a socket.
+ * Set or clear the Don't Fragment flag on a socket.  This is called for every
+ * DATA packet, so skip the socket lock if the socket already has the wanted
+ * setting.  Callers run both in the I/O thread and in connection event
+ * processing (rxkad responses), so check the socket itself rather than a
+ * cached copy that could go out of step with it.
  */
 void rxrpc_local_dont_fragment(const struct rxrpc_local *local, bool set)
 {
-	if (set)
-		ip_sock_set_mtu_discover(local->socket->sk, IP_PMTUDISC_DO);
-	else
-		ip_sock_set_mtu_discover(local->socket->sk, IP_PMTUDISC_DONT);
+	struct sock *sk = local->socket->sk;
+	int val = set ? IP_PMTUDISC_DO : IP_PMTUDISC_DONT;
+
+	if (READ_ONCE(inet_sk(sk)->pmtudisc) == val)
+		return;
+	ip_sock_set_mtu_discover(sk, val);
 }
 
 /*
@@ -52,11 +52,26 @@ svc_rdma_next_ctxt(struct list_head *list)
 }
 
 static struct svc_rdma_rw_ctxt *
-svc_rdma_get_rw_ctxt(struct svcxprt_rdma *rdma, unsigned int sges)
+svc_rdma_rw_ctxt_alloc(struct svcxprt_rdma *rdma)
 {
 	struct ib_device *dev = rdma->sc_cm_id->device;
 	unsigned int first_sgl_nents = dev->attrs.max_send_sge;
 	struct svc_rdma_rw_ctxt *ctxt;
+
+	ctxt = kmalloc_node(struct_size(ctxt, rw_first_sgl, first_sgl_nents),
+			    GFP_KERNEL, ibdev_to_node(dev));
+	if (!ctxt)
+		return NULL;
+
+	INIT_LIST_HEAD(&ctxt->rw_list);
+	ctxt->rw_first_sgl_nents = first_sgl_nents;
+	return ctxt;
+}
+
+static struct svc_rdma_rw_ctxt *
+svc_rdma_get_rw_ctxt(struct svcxprt_rdma *rdma, unsigned int sges)
+{
+	struct svc_rdma_rw_ctxt *ctxt;
 	struct llist_node *node;
 
 	spin_lock(&rdma->sc_rw_ctxt_lock);
@@ -65,19 +80,15 @@ svc_rdma_get_rw_ctxt(struct svcxprt_rdma *rdma, unsigned int sges)
 	if (node) {
 		ctxt = llist_entry(node, struct svc_rdma_rw_ctxt, rw_node);
 	} else {
-		ctxt = kmalloc_node(struct_size(ctxt, rw_first_sgl, first_sgl_nents),
-				    GFP_KERNEL, ibdev_to_node(dev));
+		ctxt = svc_rdma_rw_ctxt_alloc(rdma);
 		if (!ctxt)
 			goto out_noctx;
-
-		INIT_LIST_HEAD(&ctxt->rw_list);
-		ctxt->rw_first_sgl_nents = first_sgl_nents;
 	}
 
 	ctxt->rw_sg_table.sgl = ctxt->rw_first_sgl;
 	if (sg_alloc_table_chained(&ctxt->rw_sg_table, sges,
 				   ctxt->rw_sg_table.sgl,
-				   first_sgl_nents))
+				   ctxt->rw_first_sgl_nents))
 		goto out_free;
 	return ctxt;
 
@@ -101,6 +112,28 @@ static void svc_rdma_put_rw_ctxt(struct svcxprt_rdma *rdma,
 	__svc_rdma_put_rw_ctxt(ctxt, &rdma->sc_rw_ctxts);
 }
 
+/**
+ * svc_rdma_init_rw_ctxts - Pre-populate the R/W context free list
+ * @rdma: fresh svcxprt_rdma
+ *
+ * Allocate one R/W context per credit up front so that chunk I/O
+ * does not hit the allocator until the transport is busier than
+ * its credit limit.  Failure is not fatal: contexts are still
+ * allocated on demand.
+ */
+void svc_rdma_init_rw_ctxts(struct svcxprt_rdma *rdma)
+{
+	struct svc_rdma_rw_ctxt *ctxt;
+	unsigned int i;
+
+	for (i = 0; i < rdma->sc_max_requests; i++) {
+		ctxt = svc_rdma_rw_ctxt_alloc(rdma);
+		if (!ctxt)
+			break;
+		llist_add(&ctxt->rw_node, &rdma->sc_rw_ctxts);
+	}
+}
+
 /**
  * svc_rdma_destroy_rw_ctxts - Free accumulated R/W contexts
  * @rdma: transport about to be destroyed
@@ -524,6 +524,7 @@ static struct svc_xprt *svc_rdma_accept(struct svc_xprt *xprt)
 
 	if (!svc_rdma_post_recvs(newxprt))
 		goto errout;
+	svc_rdma_init_rw_ctxts(newxprt);
 
 	/* Construct RDMA-CM private message */
 	pmsg.cp_magic = rpcrdma_cmp_magic;
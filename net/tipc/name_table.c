@@ -596,16 +596,18 @@ bool tipc_nametbl_lookup_anycast(struct net *net,
 			if (list_empty(l))
 				continue;
 			p = list_first_entry(l, struct publication, local_publ);
-			list_move_tail(&p->local_publ, &r->local_publ);
 		} else if (legacy && !sk->node && !list_empty(&r->local_publ)) {
 			l = &r->local_publ;
 			p = list_first_entry(l, struct publication, local_publ);
-			list_move_tail(&p->local_publ, &r->local_publ);
 		} else {
 			l = &r->all_publ;
 			p = list_first_entry(l, struct publication, all_publ);
-			list_move_tail(&p->all_publ, &r->all_publ);
 		}
+		/* Round-robin; a lone binding needs no rotation, so leave
+		 * the list and the publication's cache line untouched
+		 */
+		if (!list_is_singular(l))
+			list_rotate_left(l);
 		*sk = p->sk;
 		res = true;
 		/* Todo: as for legacy, pick the first matching range only, a
@@ -651,6 +651,13 @@ static void virtio_transport_rx_work(struct work_struct *work)
 			virtio_vsock_skb_rx_put(skb);
 			virtio_transport_deliver_tap_pkt(skb);
 			virtio_transport_recv_pkt(&virtio_transport, skb);
+
+			/* Top the ring back up in one batch once half of it
+			 * has been consumed, rather than waiting for the
+			 * device to drain it and stall a bulk transfer.
+			 */
+			if (vsock->rx_buf_nr < vsock->rx_buf_max_nr / 2)
+				virtio_vsock_rx_fill(vsock);
 		}
 	} while (!virtqueue_enable_cb(vq));
 
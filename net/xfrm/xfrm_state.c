@@ -1109,6 +1109,13 @@ static struct xfrm_state *__xfrm_state_lookup(struct net *net, u32 mark,
 	return NULL;
 }
 
+/*
+ * Only this many entries of the per-CPU input cache are searched.  The cache
+ * is a plain list, and on gateways with many SAs it can hold a large share of
+ * them; past the first few entries the SPI hash is the faster lookup.
+ */
+#define XFRM_STATE_CACHE_INPUT_DEPTH	8
+
 struct xfrm_state *xfrm_input_state_lookup(struct net *net, u32 mark,
 					   const xfrm_address_t *daddr,
 					   __be32 spi, u8 proto,
@@ -1117,11 +1124,14 @@ struct xfrm_state *xfrm_input_state_lookup(struct net *net, u32 mark,
 	struct hlist_head *state_cache_input;
 	struct xfrm_state *x = NULL;
 	int cpu = get_cpu();
+	int depth = 0;
 
 	state_cache_input =  per_cpu_ptr(net->xfrm.state_cache_input, cpu);
 
 	rcu_read_lock();
 	hlist_for_each_entry_rcu(x, state_cache_input, state_cache_input) {
+		if (++depth > XFRM_STATE_CACHE_INPUT_DEPTH)
+			break;
 		if (x->props.family != family ||
 		    x->id.spi       != spi ||
 		    x->id.proto     != proto ||
@@ -1137,14 +1147,16 @@ struct xfrm_state *xfrm_input_state_lookup(struct net *net, u32 mark,
 
 	x = __xfrm_state_lookup(net, mark, daddr, spi, proto, family);
 
+	/*
+	 * Getting here means the state is not within the searched part of this
+	 * CPU's cache: it is uncached, cached on another CPU, or too far down
+	 * the list.  Move it to the front so that it is found next time.
+	 */
 	if (x && x->km.state == XFRM_STATE_VALID) {
 		spin_lock_bh(&net->xfrm.xfrm_state_lock);
-		if (hlist_unhashed(&x->state_cache_input)) {
-			hlist_add_head_rcu(&x->state_cache_input, state_cache_input);
-		} else {
+		if (!hlist_unhashed(&x->state_cache_input))
 			hlist_del_rcu(&x->state_cache_input);
-			hlist_add_head_rcu(&x->state_cache_input, state_cache_input);
-		}
+		hlist_add_head_rcu(&x->state_cache_input, state_cache_input);
 		spin_unlock_bh(&net->xfrm.xfrm_state_lock);
 	}
 
@@ -463,13 +463,20 @@ aa_state_t aa_dfa_match_len(struct aa_dfa *dfa, aa_state_t start,
 	if (dfa->tables[YYTD_ID_EC]) {
 		/* Equivalence class table defined */
 		u8 *equiv = EQUIV_TABLE(dfa);
-		for (; len; len--)
+		for (; len; len--) {
 			match_char(state, def, base, next, check,
 				   equiv[(u8) *str++]);
+			/* the null state only transitions to itself */
+			if (state == DFA_NOMATCH)
+				break;
+		}
 	} else {
 		/* default is direct to next state */
-		for (; len; len--)
+		for (; len; len--) {
 			match_char(state, def, base, next, check, (u8) *str++);
+			if (state == DFA_NOMATCH)
+				break;
+		}
 	}
 
 	return state;
@@ -503,13 +510,20 @@ aa_state_t aa_dfa_match(struct aa_dfa *dfa, aa_state_t start, const char *str)
 		/* Equivalence class table defined */
 		u8 *equiv = EQUIV_TABLE(dfa);
 		/* default is direct to next state */
-		while (*str)
+		while (*str) {
 			match_char(state, def, base, next, check,
 				   equiv[(u8) *str++]);
+			/* the null state only transitions to itself */
+			if (state == DFA_NOMATCH)
+				break;
+		}
 	} else {
 		/* default is direct to next state */
-		while (*str)
+		while (*str) {
 			match_char(state, def, base, next, check, (u8) *str++);
+			if (state == DFA_NOMATCH)
+				break;
+		}
 	}
 
 	return state;
@@ -27,6 +27,13 @@ static unsigned long ima_ahash_minsize;
 module_param_named(ahash_minsize, ima_ahash_minsize, ulong, 0644);
 MODULE_PARM_DESC(ahash_minsize, "Minimum file size for ahash use");
 
+/*
+ * Upper bound for the shash read buffer.  Unlike the ahash buffer it is not
+ * tunable: it only saves VFS read round trips and is always allocated
+ * opportunistically.
+ */
+#define IMA_SHASH_MAX_ORDER	4
+
 /* default is 0 - 1 page. */
 static int ima_maxorder;
 static unsigned int ima_bufsize = PAGE_SIZE;
@@ -221,25 +228,25 @@ static void ima_free_tfm(struct crypto_shash *tfm)
 }
 
 /**
- * ima_alloc_pages() - Allocate contiguous pages.
+ * __ima_alloc_pages() - Allocate contiguous pages.
  * @max_size:       Maximum amount of memory to allocate.
  * @allocated_size: Returned size of actual allocation.
  * @last_warn:      Should the min_size allocation warn or not.
+ * @maxorder:       Upper bound for the allocation order.
  *
  * Tries to do opportunistic allocation for memory first trying to allocate
- * max_size amount of memory and then splitting that until zero order is
- * reached. Allocation is tried without generating allocation warnings unless
- * last_warn is set. Last_warn set affects only last allocation of zero order.
- *
- * By default, ima_maxorder is 0 and it is equivalent to kmalloc(GFP_KERNEL)
+ * max_size amount of memory, but no more than @maxorder, and then splitting
+ * that until zero order is reached. Allocation is tried without generating
+ * allocation warnings unless last_warn is set. Last_warn set affects only
+ * last allocation of zero order.
  *
  * Return pointer to allocated memory, or NULL on failure.
  */
-static void *ima_alloc_pages(loff_t max_size, size_t *allocated_size,
-			     int last_warn)
+static void *__ima_alloc_pages(loff_t max_size, size_t *allocated_size,
+			       int last_warn, int maxorder)
 {
 	void *ptr;
-	int order = ima_maxorder;
+	int order = maxorder;
 	gfp_t gfp_mask = __GFP_RECLAIM | __GFP_NOWARN | __GFP_NORETRY;
 
 	if (order)
@@ -270,6 +277,22 @@ static void *ima_alloc_pages(loff_t max_size, size_t *allocated_size,
 	return NULL;
 }
 
+/**
+ * ima_alloc_pages() - Allocate contiguous pages for the ahash path.
+ * @max_size:       Maximum amount of memory to allocate.
+ * @allocated_size: Returned size of actual allocation.
+ * @last_warn:      Should the min_size allocation warn or not.
+ *
+ * See __ima_alloc_pages(), bounded by the ahash_bufsize parameter. By
+ * default, ima_maxorder is 0 and it is equivalent to kmalloc(GFP_KERNEL).
+ */
+static void *ima_alloc_pages(loff_t max_size, size_t *allocated_size,
+			     int last_warn)
+{
+	return __ima_alloc_pages(max_size, allocated_size, last_warn,
+				 ima_maxorder);
+}
+
 /**
  * ima_free_pages() - Free pages allocated by ima_alloc_pages().
  * @ptr:  Pointer to allocated pages.
@@ -453,6 +476,7 @@ static int ima_calc_file_hash_tfm(struct file *file,
 				  struct crypto_shash *tfm)
 {
 	loff_t i_size, offset = 0;
+	size_t rbuf_size;
 	char *rbuf;
 	int rc;
 	SHASH_DESC_ON_STACK(shash, tfm);
@@ -470,14 +494,19 @@ static int ima_calc_file_hash_tfm(struct file *file,
 	if (i_size == 0)
 		goto out;
 
-	rbuf = kzalloc(PAGE_SIZE, GFP_KERNEL);
+	/*
+	 * Read large files in bigger chunks to cut down on the number of
+	 * VFS reads, but don't try hard to get a high-order allocation.
+	 */
+	rbuf = __ima_alloc_pages(i_size, &rbuf_size, 0, IMA_SHASH_MAX_ORDER);
 	if (!rbuf)
 		return -ENOMEM;
 
 	while (offset < i_size) {
 		int rbuf_len;
 
-		rbuf_len = integrity_kernel_read(file, offset, rbuf, PAGE_SIZE);
+		rbuf_len = integrity_kernel_read(file, offset, rbuf,
+						 rbuf_size);
 		if (rbuf_len < 0) {
 			rc = rbuf_len;
 			break;
@@ -492,7 +521,7 @@ static int ima_calc_file_hash_tfm(struct file *file,
 		if (rc)
 			break;
 	}
-	kfree(rbuf);
+	ima_free_pages(rbuf, rbuf_size);
 out:
 	if (!rc)
 		rc = crypto_shash_final(shash, hash->digest);
@@ -0,0 +1,30 @@
+#!/bin/bash
+# SPDX-License-Identifier: GPL-2.0
+
+source ./benchs/run_common.sh
+
+set -eufo pipefail
+
+# Sweep key size, table size and preallocation for hashmap lookups and
+# print one CSV line per configuration so results can be diffed across
+# kernels: map_flags,key_size,max_entries,nr_entries,M lookups/s
+hashmap_lookup()
+{
+	local flags=$1 key=$2 max=$3 nr=$4
+
+	printf "%s,%s,%s,%s,%s\n" $flags $key $max $nr \
+		"$($RUN_BENCH -q -p1 --map_flags $flags --key_size $key \
+			--max_entries $max --nr_entries $nr bpf-hashmap-lookup)"
+}
+
+header "Hashmap lookup"
+echo "map_flags,key_size,max_entries,nr_entries,M_lookups_per_sec"
+# 0: preallocated, 0x1: BPF_F_NO_PREALLOC
+for f in 0 0x1; do
+for k in 4 8 16 32 64 128; do
+for e in 1000 10000 100000 1000000; do
+	hashmap_lookup $f $k $e $((e / 2))
+	hashmap_lookup $f $k $e $e
+done
+done
+done
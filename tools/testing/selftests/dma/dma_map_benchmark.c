@@ -21,6 +21,31 @@ static char *directions[] = {
 	"FROM_DEVICE",
 };
 
+static char *modes[] = {
+	"SINGLE",
+	"SG",
+	"PAGE",
+	"BOUNCE",
+};
+
+static void print_hist(const char *name, __u64 *hist)
+{
+	int i;
+
+	printf("%s latency histogram(ns):\n", name);
+	for (i = 0; i < DMA_MAP_HIST_BUCKETS; i++) {
+		if (!hist[i])
+			continue;
+		if (i == DMA_MAP_HIST_BUCKETS - 1)
+			printf("%12llu+          : %llu\n",
+			       1ULL << (i - 1), (unsigned long long)hist[i]);
+		else
+			printf("%12llu - %-10llu: %llu\n",
+			       i ? 1ULL << (i - 1) : 0ULL, (1ULL << i) - 1,
+			       (unsigned long long)hist[i]);
+	}
+}
+
 int main(int argc, char **argv)
 {
 	struct map_benchmark map;
@@ -31,10 +56,12 @@ int main(int argc, char **argv)
 	int bits = 32, xdelay = 0, dir = DMA_MAP_BIDIRECTIONAL;
 	/* default granule 1 PAGESIZE */
 	int granule = 1;
+	/* default dma_map_single(), scatterlist of one entry */
+	int mode = DMA_MAP_SINGLE_MODE, nents = 1;
 
 	int cmd = DMA_MAP_BENCHMARK;
 
-	while ((opt = getopt(argc, argv, "t:s:n:b:d:x:g:")) != -1) {
+	while ((opt = getopt(argc, argv, "t:s:n:b:d:x:g:m:e:")) != -1) {
 		switch (opt) {
 		case 't':
 			threads = atoi(optarg);
@@ -57,6 +84,12 @@ int main(int argc, char **argv)
 		case 'g':
 			granule = atoi(optarg);
 			break;
+		case 'm':
+			mode = atoi(optarg);
+			break;
+		case 'e':
+			nents = atoi(optarg);
+			break;
 		default:
 			return -1;
 		}
@@ -92,11 +125,22 @@ int main(int argc, char **argv)
 		exit(1);
 	}
 
-	if (granule < 1 || granule > 1024) {
+	if (granule < 1 || granule > DMA_MAP_MAX_GRANULE) {
 		fprintf(stderr, "invalid granule size\n");
 		exit(1);
 	}
 
+	if (mode < 0 || mode >= DMA_MAP_MODE_MAX) {
+		fprintf(stderr, "invalid mapping mode\n");
+		exit(1);
+	}
+
+	if (nents < 1 || nents > granule) {
+		fprintf(stderr, "invalid number of sg entries, must be in 1-%d\n",
+			granule);
+		exit(1);
+	}
+
 	fd = open("/sys/kernel/debug/dma_map_benchmark", O_RDWR);
 	if (fd == -1) {
 		perror("open");
@@ -111,18 +155,25 @@ int main(int argc, char **argv)
 	map.dma_dir = dir;
 	map.dma_trans_ns = xdelay;
 	map.granule = granule;
+	map.map_mode = mode;
+	map.sg_nents = nents;
 
 	if (ioctl(fd, cmd, &map)) {
 		perror("ioctl");
 		exit(1);
 	}
 
-	printf("dma mapping benchmark: threads:%d seconds:%d node:%d dir:%s granule: %d\n",
-			threads, seconds, node, dir[directions], granule);
+	printf("dma mapping benchmark: threads:%d seconds:%d node:%d dir:%s granule: %d mode:%s",
+			threads, seconds, node, dir[directions], granule, modes[mode]);
+	if (mode == DMA_MAP_SG_MODE)
+		printf(" sg entries:%d", nents);
+	printf("\n");
 	printf("average map latency(us):%.1f standard deviation:%.1f\n",
 			map.avg_map_100ns/10.0, map.map_stddev/10.0);
 	printf("average unmap latency(us):%.1f standard deviation:%.1f\n",
 			map.avg_unmap_100ns/10.0, map.unmap_stddev/10.0);
+	print_hist("map", map.map_hist);
+	print_hist("unmap", map.unmap_hist);
 
 	return 0;
 }